@@ -2,6 +2,17 @@
 
 #include "DbInterface.hpp"
 #include "Server.hpp"
+#include "NegativeCache.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace cpr
+{
+    class Session;
+}
 
 using namespace xtypes;
 
@@ -12,8 +23,13 @@ namespace xdbi
     {
     public:
         Client(const XTypeRegistryPtr registry, const std::string& dbAddress, const std::string graph);
+        ~Client();
 
         /** \brief Checks whether the client can communicate with the Server
+         * The outcome of the last request is reused for the readiness TTL (see setReadinessTTL()), so the server is only pinged
+         * if there has been no successful contact recently.
+         * NOTE: Operations do not ping at all. Every answered request marks the client as ready, so an operation sends exactly one request.
+         * After a failed contact, operations fail at once until the retry interval (see setRetryInterval()) has passed.
          * \return true if the client is connected */
         bool isReady();
         /** Pings the server and returns time it took for the server to respond in milliseconds
@@ -26,6 +42,31 @@ namespace xdbi
         void setDbUser(const std::string &_dbUser);
         /// \brief "Sets the password if the server requires one. Default: '' "
         void setDbPassword(const std::string &_dbPassword);
+        /** \brief "Sets the maximum number of keep-alive connections (sessions) held to the server. Default: 4"
+         * Requests from multiple threads share these sessions; if all of them are busy, a request waits for the next free one.
+         */
+        void setConnectionPoolSize(const std::size_t size);
+        std::size_t getConnectionPoolSize();
+        /** \brief "Sets for how many milliseconds a successful contact to the server counts as being ready. Default: 5000"
+         * A TTL of 0 makes isReady() ping the server on every call.
+         */
+        void setReadinessTTL(const std::time_t ttl_ms);
+        /** \brief "Sets for how many milliseconds after a failed contact operations fail without asking the server. Default: 100"
+         * This keeps an unreachable server from being flooded, while a server which (re)appears is used almost at once.
+         * A retry interval of 0 makes every operation try the server again.
+         */
+        void setRetryInterval(const std::time_t interval_ms);
+        /// \brief "Starts a background thread which pings the server every interval_ms (> 0) milliseconds to keep the readiness up to date"
+        void startHealthCheck(const std::time_t interval_ms);
+        /// \brief "Stops the background health check (if running)"
+        void stopHealthCheck();
+        /** \brief "Configures the cache of unresolved uris. Default: disabled (10000 entries which are valid for 0 ms)"
+         * Repeated loads of uris which do not exist are answered from this cache. It is cleared by any write through this Client
+         * and whenever getMembership() reports a new generation of the graph. A TTL of 0 disables the cache.
+         * NOTE: Uris which others add are reported as missing until their entries expire (or getMembership() is called).
+         */
+        void setNegativeCache(const std::size_t capacity, const std::time_t ttl_ms);
+        void invalidateCaches() override;
 
         void setWorkingGraph(const std::string &graph) override;
         std::string getWorkingGraph() override;
@@ -33,20 +74,67 @@ namespace xdbi
         std::string getAbsoluteDbPath() override;
 
         XTypePtr load(const std::string &uri, const std::string &classname = "") override;
+        nl::json loadSpec(const std::string &uri, const std::string &classname = "") override;
+        nl::json loadSubgraphSpecs(const std::string &uri, const int max_depth = -1, const std::set<std::string> &relations = {}) override;
         bool clear() override;
         bool remove(const std::string &uri) override;
         bool add(std::vector<XTypePtr> xtypes, const int max_depth=-1) override;
         bool add(nl::json xtypes) override;
         bool update(std::vector<XTypePtr> xtypes, const int max_depth=-1) override;
         bool update(nl::json xtypes) override;
+        bool patch(const std::string &uri, const nl::json &patch) override;
         std::vector<XTypePtr> find(const std::string &classname="", const nl::json &properties=nl::json{}) override;
+        nl::json findSpecs(const std::string &classname="", const nl::json &properties=nl::json{}, const std::vector<std::string> &fields={}) override;
+        nl::json findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset = 0,
+                          const std::string &cursor = "", const std::vector<std::string> &fields = {}) override;
         std::set<std::string> uris(const std::string &classname="", const nl::json &properties=nl::json{}) override;
+        nl::json findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                            const std::size_t limit = 0, const std::vector<std::string> &fields = {}) override;
+        std::size_t count(const std::string &classname="", const nl::json &properties=nl::json{}) override;
+        nl::json groupCount(const std::string &classname, const std::string &property, const nl::json &properties=nl::json{}) override;
+        nl::json findEdgesFrom(const std::vector<std::string> &uris) override;
+        nl::json findEdgesTo(const std::vector<std::string> &uris) override;
+        nl::json traverse(const std::string &uri, const std::set<std::string> &relations = {}, const std::string &direction = "out",
+                          const int max_depth = -1, const bool depth_first = false, const bool uris_only = false) override;
+        MembershipPtr getMembership(const MembershipPtr &known = nullptr) override;
 
     protected:
+        /// Throws if no graph is set or the last contact failed less than the retry interval ago. Unlike isReady(), it never pings.
+        void checkReadiness() override;
+        /// RAII handle on a session borrowed from the pool (see Client.cpp)
+        struct SessionLease;
+        /// Sends the request via a pooled session and returns the parsed response. Throws if the server does not answer.
+        nl::json request(const nl::json &dbRequest, const std::string &caller);
+        std::unique_ptr<cpr::Session> acquireSession();
+        void releaseSession(std::unique_ptr<cpr::Session> session);
+        /// Records the outcome of a request to the server
+        void updateReadiness(const bool reachable);
+        /// Returns true if the server answered that it does not know the type of the request (i.e. it is older than this Client)
+        static bool isUnsupported(const nl::json &response);
+
         std::string dbAddress = "http://localhost:8183";
         std::string dbUser = "";
         std::string dbPassword = "";
         std::string workingGraph = "";
+
+        std::size_t poolSize = 4;
+        std::size_t openSessions = 0;
+        std::vector<std::unique_ptr<cpr::Session>> idleSessions;
+        std::mutex sessionsMutex;
+        std::condition_variable sessionAvailable;
+
+        std::atomic<bool> reachable{false};
+        std::atomic<std::chrono::steady_clock::time_point> lastContact{std::chrono::steady_clock::time_point()};
+        std::atomic<std::time_t> readinessTTL{5000};
+        std::atomic<std::time_t> retryInterval{100};
+
+        std::thread healthCheckThread;
+        bool healthCheckRunning = false;
+        std::mutex healthCheckMutex;
+        std::condition_variable healthCheckStopped;
+
+        NegativeCache unresolved;
+        std::atomic<std::size_t> lastGeneration{0};
     };
 
 }
@@ -1,17 +1,36 @@
 #pragma once
 #include <memory>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <xtypes_generator/XTypeRegistry.hpp>
 #include <xtypes_generator/XType.hpp>
 #include <nlohmann/json.hpp>
+#include "Executor.hpp"
 using namespace xtypes;
 namespace nl = nlohmann;
 
 namespace xdbi
 {
+    /** A compact summary of the uris stored in a database graph.
+     *  The uris are represented by their uuids (see xtypes::uri_to_uuid()), which are also the file names in the database.
+     */
+    struct Membership
+    {
+        std::string graph;
+        /// Changes whenever models are added to or removed from the graph
+        std::size_t generation = 0;
+        std::unordered_set<std::string> uuids;
+        /// Returns false only if the uri is definitely not stored
+        bool mayContain(const std::string &uri) const;
+    };
+    using MembershipPtr = std::shared_ptr<const Membership>;
+
     // 20220609 HW: We should again try to introduce const correctness here
     /** This is the base class for all classes that connect to the database
     */
-    class DbInterface
+    class DbInterface : public std::enable_shared_from_this<DbInterface>
     {
     public:
         /// Constructor with registry
@@ -75,6 +94,27 @@ namespace xdbi
            \return "The XType instance if found otherwise nullptr"
         */
         virtual XTypePtr load(const std::string &uri, const std::string &classname = "") = 0;
+        /*!
+           \brief "Like load() but returns the serialized model instead of creating an XType instance"
+           \param "The uri of the model to load"
+           \param "(optional) The classname of the model to load, if known"
+           \return "The model if found otherwise an empty json"
+        */
+        virtual nl::json loadSpec(const std::string &uri, const std::string &classname = "") = 0;
+        /*!
+           \brief "Loads the XType specified via the passed uri together with all XTypes reachable via its relations in one call"
+           All loaded XTypes are imported into the registry, so resolving their facts later on does not trigger further loads.
+           \param "The uri of the XType to load"
+           \param "How many relations to follow (-1: unlimited)"
+           \param "The names of the relations to follow (empty: all)"
+           \return "The XType instance if found otherwise nullptr"
+        */
+        virtual XTypePtr loadSubgraph(const std::string &uri, const int max_depth = -1, const std::set<std::string> &relations = {});
+        /*!
+           \brief "Like loadSubgraph() but returns the serialized models (in breadth-first order, the root first)"
+           The default implementation follows the relations by loadSpec(); Serverless and Client let the backend do it at once.
+        */
+        virtual nl::json loadSubgraphSpecs(const std::string &uri, const int max_depth = -1, const std::set<std::string> &relations = {});
         /*!
            \brief "Deletes all entries in the current working graph/directory"
         */
@@ -108,13 +148,51 @@ namespace xdbi
            \param xtypes "A vector of serialized Xtypes to be added to the database"
         */
         virtual bool update(nl::json xtypes) = 0;
+        /*!
+           \brief "Applies a patch to the stored model of the passed uri, so only the changes have to be transferred"
+           The default implementation loads, patches and updates the model. Serverless and Client patch it in the backend under its lock.
+           \param uri "The uri of the model to patch"
+           \param patch "Either a JSON Patch (RFC 6902, array of operations) or a JSON Merge Patch (RFC 7386, object). uri, uuid and classname cannot be patched."
+           NOTE: Models stored in the old flat format (without "properties") cannot be patched.
+           \return "True if the model has been patched, false if it does not exist"
+        */
+        virtual bool patch(const std::string &uri, const nl::json &patch);
         /*!
           \brief "Loads all xtypes that match the passed classname and properties and returns them as vector. If classname is provided this limits the search area, and is therefore faster."
           \param "The classname of the XType to load"
-          \param "Certain properties the XType(s) to be retrieved have to have"
+          \param "Certain properties the XType(s) to be retrieved have to have (or a query with operators, see Query)"
           \return "a vector of matching XType instances"
         */
         virtual std::vector<XTypePtr> find(const std::string &classname="", const nl::json &properties=nl::json{}) = 0;
+        /*!
+          \brief "Like find() but returns the matching serialized models instead of creating XType instances"
+          \param "The classname of the models to find"
+          \param "Certain properties the model(s) to be retrieved have to have"
+          \param "(optional) The top-level fields of the models to return (the uri is always returned). Empty: complete models"
+          \return "a json array of matching models"
+        */
+        virtual nl::json findSpecs(const std::string &classname="", const nl::json &properties=nl::json{}, const std::vector<std::string> &fields={}) = 0;
+        /*!
+          \brief "Like findSpecs() but returns only one page of the matching models, so huge result sets can be processed with bounded memory"
+          Serverless and Client order the models by their uuids and parse/transfer only the requested page.
+          The default implementation pages through the complete, uri-ordered result of findSpecs().
+          \param "The maximum number of models on the page (0: unlimited)"
+          \param "The number of matching models to skip (after the cursor)"
+          \param "The cursor returned with the previous page (empty: start at the beginning)"
+          \return "{"models": [...], "cursor": <cursor of the next page>}; an empty cursor marks the last page"
+        */
+        virtual nl::json findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset = 0,
+                                  const std::string &cursor = "", const std::vector<std::string> &fields = {});
+        /*!
+          \brief "Like findSpecs() but returns only the first matching models in the order given by the sort keys"
+          Serverless and Client keep only the best models while scanning in the backend, so only those are transferred.
+          The default implementation sorts the complete result of findSpecs().
+          \param "The sort keys: property paths (see Query), prefixed with '-' to sort descending, e.g. {"-modified", "name"}"
+          \param "The maximum number of models to return (0: all)"
+          \return "a json array of the first matching models"
+        */
+        virtual nl::json findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                                    const std::size_t limit = 0, const std::vector<std::string> &fields = {});
 
         /*
          * \brief "Returns a list of all uris present in the database"
@@ -123,7 +201,91 @@ namespace xdbi
          * \return "A set of URI strings"
          */
         virtual std::set<std::string> uris(const std::string &classname="", const nl::json &properties=nl::json{}) = 0;
+        /*!
+           \brief "Returns the number of models of classname which match the properties, without transferring them"
+           The default implementation counts the result of uris(). Serverless and Client let the backend count the files or matches.
+        */
+        virtual std::size_t count(const std::string &classname="", const nl::json &properties=nl::json{});
+        /*!
+           \brief "Counts the matching models of classname per value of the passed property"
+           \param property "The property to group by (a path like in a query, e.g. "name" or "pose.frame")"
+           \return "{<value>: <count>}; string values are used as is, other values are serialized. Models without the property are not counted."
+        */
+        virtual nl::json groupCount(const std::string &classname, const std::string &property, const nl::json &properties=nl::json{});
+
+        /*!
+           \brief "Returns the edges starting at the passed uris without transferring the complete models"
+           The default implementation loads the models. Serverless and Client let the backend extract the edges.
+           \param uris "The uris of the sources"
+           \return "{<source uri>: {<relation>: [{"source", "target", "edge_properties", ...}, ...]}}"
+        */
+        virtual nl::json findEdgesFrom(const std::vector<std::string> &uris);
+        /*!
+           \brief "Returns the edges ending at the passed uris (in the same format as findEdgesFrom())"
+           The default implementation finds the sources by an $edge query. Serverless and Client use the adjacency index of the backend.
+        */
+        virtual nl::json findEdgesTo(const std::vector<std::string> &uris);
+        /*!
+           \brief "Traverses the graph from the passed uri along the edges of the passed relations, e.g. to compute transitive closures"
+           Every uri is visited once, so cycles are cut. Referenced uris which are not stored are visited as well (but not followed).
+           The default implementation asks for the edges of every visited uri. Serverless and Client let the backend traverse its adjacency index at once.
+           \param uri "The uri to start at"
+           \param relations "The names of the relations to follow (empty: all)"
+           \param direction ""out" (from source to target), "in" (from target to source) or "both""
+           \param max_depth "How many edges to follow (-1: unlimited)"
+           \param depth_first "Visit depth-first instead of breadth-first"
+           \param uris_only "Return the visited uris instead of the models"
+           \return "The visited uris or models in visiting order (the start first)"
+        */
+        virtual nl::json traverse(const std::string &uri, const std::set<std::string> &relations = {}, const std::string &direction = "out",
+                                  const int max_depth = -1, const bool depth_first = false, const bool uris_only = false);
         
+        /*!
+           \brief "Returns a compact summary of the uris stored in the current working graph"
+           \param known "A previously returned summary. If it is still up to date, it is returned as is, so no uuids have to be transferred."
+           \return "The summary or nullptr if this DbInterface cannot provide one"
+        */
+        virtual MembershipPtr getMembership(const MembershipPtr &known = nullptr);
+
+        /*!
+           \brief "Drops any cached information about the database content (e.g. unresolved uris), because it has been changed by someone else"
+        */
+        virtual void invalidateCaches() {}
+
+        /*!
+           \brief "Asynchronous variants of load(), find(), uris(), add(), update(), remove() and clear()"
+           The calls are executed on the shared Executor and the returned futures provide the result (or rethrow the error).
+           Independent calls, e.g. on different graphs or servers, can therefore overlap.
+           NOTE: If this DbInterface is not owned by a std::shared_ptr, it has to outlive the returned futures.
+        */
+        virtual std::future<XTypePtr> loadAsync(const std::string &uri, const std::string &classname = "");
+        virtual std::future<std::vector<XTypePtr>> findAsync(const std::string &classname="", const nl::json &properties=nl::json{});
+        virtual std::future<std::set<std::string>> urisAsync(const std::string &classname="", const nl::json &properties=nl::json{});
+        virtual std::future<bool> addAsync(std::vector<XTypePtr> xtypes, const int max_depth=-1);
+        virtual std::future<bool> addAsync(nl::json xtypes);
+        virtual std::future<bool> updateAsync(std::vector<XTypePtr> xtypes, const int max_depth=-1);
+        virtual std::future<bool> updateAsync(nl::json xtypes);
+        virtual std::future<bool> removeAsync(const std::string &uri);
+        virtual std::future<bool> clearAsync();
+
+        /*!
+           \brief "Enables/disables the identity map (default: disabled)"
+           If enabled, loading a model whose serialization did not change since the last load returns the already existing XType instance
+           (as long as it is alive) instead of deserializing a new one. Shared dependencies are thereby only kept once in memory.
+           NOTE: Unsaved local changes of such an instance are therefore visible to the next load() of the same uri.
+           Can also be enabled by "identity_map": true in the config passed to from_config().
+        */
+        void setIdentityMap(const bool enabled);
+
+        /*!
+           \brief "Enables/disables dirty tracking (default: disabled)"
+           If enabled, update() with XTypes only sends the models whose serialization differs from the one they have been loaded with.
+           Changes made by others in between are therefore not overwritten by unchanged models.
+           NOTE: Writes of this DbInterface forget the loaded state of the written models, so these are always sent until they are loaded again.
+           Can also be enabled by "dirty_tracking": true in the config passed to from_config().
+        */
+        void setDirtyTracking(const bool enabled);
+
         /**
          * @brief Get the Config from which this Backend constructed from
          *
@@ -141,7 +303,40 @@ namespace xdbi
         std::weak_ptr<XTypeRegistry> registry;
         nl::json config;
         bool read_only = false;
-        void checkReadiness();
+        /// Throws if this DbInterface is not ready (see isReady())
+        virtual void checkReadiness();
         void checkWriteable();
+
+        /// Turns a membership summary of the JsonDatabaseBackend into a Membership (or returns known if the summary contains no changes)
+        static MembershipPtr parseMembership(const std::string &graph, const nl::json &summary, const MembershipPtr &known);
+        /// Creates (and registers) the XType described by the passed serialized model. Returns nullptr for an empty model.
+        XTypePtr importSpec(const nl::json &spec);
+        /// Serializes the passed XTypes and all their dependencies up to max_depth into an array of models (every uri only once)
+        nl::json exportSpecs(const std::vector<XTypePtr> &xtypes, const int max_depth);
+        /// Already imported XTypes by uri together with the hash of the model they were imported from
+        struct Identity
+        {
+            std::size_t spec_hash;
+            std::weak_ptr<XType> instance;
+        };
+        bool use_identity_map = false;
+        std::unordered_map<std::string, Identity> identities;
+        std::size_t identities_prune_at = 1024;
+        /// Hashes of the models as they have been loaded from the database (by uri)
+        bool dirty_tracking = false;
+        std::unordered_map<std::string, std::size_t> synced;
+        /// Returns only those of the passed models which differ from their synced state
+        nl::json dropUnchanged(const nl::json &models);
+        /// Forgets the synced state of the passed models (or of all models), e.g. because they have been written or removed differently
+        void forgetSynced(const nl::json &models);
+        void forgetSynced();
+        /// The XTypeRegistry is not thread-safe, so every import/export is serialized by this (recursive) mutex
+        static std::recursive_mutex &registryMutex();
+        /// Runs the passed callable on the shared Executor while keeping this instance alive (if owned by a std::shared_ptr)
+        template <typename F>
+        auto async(F &&f)
+        {
+            return Executor::shared().submit([keep_alive = weak_from_this().lock(), f = std::forward<F>(f)]() mutable { return f(); });
+        }
     };
 }
@@ -0,0 +1,65 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace xdbi
+{
+    /**
+     * @brief A fixed size thread pool on which asynchronous database calls are executed
+     */
+    class Executor
+    {
+    public:
+        /// Constructor which spawns num_threads worker threads
+        Executor(const std::size_t num_threads);
+        /// Destructor. Waits until all scheduled jobs are done.
+        ~Executor();
+
+        /**
+         * @brief Returns the executor shared by all DbInterface instances
+         */
+        static Executor &shared();
+
+        /**
+         * @brief Schedules the passed callable and returns a future to its result
+         * NOTE: When called from one of the worker threads of this executor, the callable is executed immediately.
+         * This way nested calls (e.g. a MultiDbClient calling its import interfaces) cannot deadlock the pool.
+         */
+        template <typename F>
+        auto submit(F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+        {
+            using R = std::invoke_result_t<std::decay_t<F>>;
+            auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+            std::future<R> result = task->get_future();
+            if (this->isWorkerThread())
+            {
+                (*task)();
+                return result;
+            }
+            this->enqueue([task]() { (*task)(); });
+            return result;
+        }
+
+        /// Returns true if the calling thread is one of the worker threads of this executor
+        bool isWorkerThread() const;
+        /// Returns the number of worker threads
+        std::size_t size() const;
+
+    private:
+        void enqueue(std::function<void()> job);
+        void run();
+
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> jobs;
+        std::mutex jobsMutex;
+        std::condition_variable jobAvailable;
+        bool stopping = false;
+    };
+}
@@ -35,6 +35,10 @@ namespace xdbi
         std::string getFileName(const std::string& uri);
         fs::path createFilePath(const std::string& graph, const std::string& classname, const std::string& uri);
         std::map<std::string, fs::path> getFiles(const std::string &graph, const std::string &classname = "");
+        // Returns a stamp which changes whenever files are added to or removed from the graph
+        std::size_t getGeneration(const std::string &graph);
+        // Returns the stamp of the passed files of a graph (see getFiles()), so they do not have to be listed twice
+        static std::size_t getGeneration(const std::map<std::string, fs::path> &files);
         bool removeFiles(const std::string &graph, const std::set<std::string>& uris);
         bool removeAllFiles(const std::string &graph);
 
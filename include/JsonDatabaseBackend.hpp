@@ -1,9 +1,13 @@
 #pragma once
 
 #include "FilesystemBasedBackend.hpp"
+#include <functional>
+#include <mutex>
 
 namespace xdbi
 {
+    class Query;
+
     /**
      * @brief JsonDatabaseBackend class
      */
@@ -17,32 +21,174 @@ namespace xdbi
 
         bool add(const nl::json &models) override;
         bool update(const nl::json &models) override;
+        /**
+         * @brief Finds the models of classname which match the query in properties (see Query for the supported operators)
+         * A query on the uri ({"uri": ...} or {"uri": {"$in": [...]}}) is answered by looking the models up directly.
+         * Edge conditions ($edge) are answered from the adjacency index, so only the models with matching edges are parsed.
+         * Throws std::invalid_argument if the query is malformed.
+         */
         nl::json find(const std::string &classname, const nl::json &properties) override;
+        /**
+         * @brief Like find() but returns only the passed top-level fields (and the uri) of the matching models
+         * @param fields: The fields to return (empty: all). Other fields are skipped while parsing the files.
+         */
+        nl::json find(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields);
+        /**
+         * @brief Like find() but returns only the first limit matching models in the order given by the sort keys (see SortOrder)
+         * Only the best limit models are kept (in a bounded heap) while scanning, so the complete result never exists in memory.
+         * @param limit: The maximum number of models to return (0: all)
+         */
+        nl::json findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                            const std::size_t limit = 0, const std::vector<std::string> &fields = {});
+        /**
+         * @brief Returns the number of models of classname which match the query in properties
+         * Without a query the models are counted in the adjacency index. Otherwise only the keys needed by the query are parsed.
+         */
+        std::size_t count(const std::string &classname, const nl::json &properties = nl::json{});
+        /**
+         * @brief Counts the matching models of classname per value of property (a path like in a query)
+         * @return {<value>: <count>} where string values are used as is and other values are serialized. Models without the property are not counted.
+         */
+        nl::json groupCount(const std::string &classname, const std::string &property, const nl::json &properties = nl::json{});
+        /**
+         * @brief Like find() but hands the matching (projected) models to the visitor one at a time instead of collecting them
+         * Only one model is held in memory at a time.
+         */
+        void findEach(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields,
+                      const std::function<void(const nl::json &)> &visitor);
+        /**
+         * @brief Parses the models of classname (or all models if empty) in the working graph one at a time and hands them to the visitor
+         * The scan stops as soon as the visitor returns false. Only one model is held in memory at a time.
+         * @return true if all models have been visited
+         */
+        bool forEach(const std::string &classname, const std::function<bool(nl::json &)> &visitor);
+        /// Like forEach() but visits the models of the passed graph instead of the working graph
+        bool forEach(const std::string &graph, const std::string &classname, const std::function<bool(nl::json &)> &visitor);
+        /**
+         * @brief Like find() but returns one page of at most limit matching models: {"models": [...], "cursor": <continuation>}
+         * The models are ordered by their file names (uuids). Passing the returned cursor continues after the last returned model;
+         * an empty cursor marks the last page. Only the files up to the end of the page are parsed.
+         * @param limit: The maximum number of models on the page (0: unlimited)
+         * @param offset: The number of matching models to skip (after the cursor)
+         */
+        nl::json findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset = 0,
+                          const std::string &cursor = "", const std::vector<std::string> &fields = {});
+        /**
+         * @brief Applies a patch to the stored model of uri and updates it like update() does
+         * @param patch: Either a JSON Patch (RFC 6902, array of operations) or a JSON Merge Patch (RFC 7386, object)
+         * @return false if there is no model with this uri
+         */
+        bool patch(const std::string &uri, const nl::json &patch);
         bool remove(const std::string &uri) override;
         bool clear() override;
         nl::json load(const std::string &uri, const std::string &classname = "");
+        /**
+         * @brief Loads the model of uri and all models reachable via its relations in breadth-first order (the root first)
+         * @param max_depth: How many relations to follow (negative: unlimited)
+         * @param relations: The names of the relations to follow (empty: all)
+         */
+        nl::json loadSubgraph(const std::string &uri, const int max_depth = -1, const std::set<std::string> &relations = {});
+        /**
+         * @brief Traverses the graph from uri along the edges of the passed relations, using the adjacency index
+         * Every uri is visited once, so cycles are cut. Uris which are referenced but not stored in the graph are visited as well (without following them).
+         * @param relations: The names of the relations to follow (empty: all)
+         * @param direction: "out" (from source to target), "in" (from target to source) or "both"
+         * @param max_depth: How many edges to follow (negative: unlimited)
+         * @param depth_first: Visit depth-first instead of breadth-first
+         * @param uris_only: Return the visited uris instead of the stored models
+         * @return The visited uris or models in visiting order (the start first)
+         */
+        nl::json traverse(const std::string &uri, const std::set<std::string> &relations = {}, const std::string &direction = "out",
+                          const int max_depth = -1, const bool depth_first = false, const bool uris_only = false);
+        /// Returns the edges starting at the uris: {<source uri>: {<relation>: [edges]}}
         nl::json findEdgesFrom(const std::vector<std::string> &uris);
+        /**
+         * @brief Returns the edges ending at the uris (in the same format as findEdgesFrom()). They are looked up in the adjacency index.
+         * NOTE: The index is refreshed by mtime and size of the files, which may miss a rewrite by another process. Write paths (remove()
+         * and removeEdgesTo()) therefore scan all models instead.
+         */
         nl::json findEdgesTo(const std::vector<std::string> &uris);
         void removeEdgesTo(const std::vector<std::string> &uris);
+        /**
+         * @brief Returns the membership summary of the working graph: {"generation": <stamp>, "uuids": [<file names>]}
+         * @param known_generation: If it matches the current generation, only the generation is returned
+         */
+        nl::json getMembership(const std::size_t known_generation = 0);
 
         void setWorkingGraph(const std::string &graph);
         std::string getWorkingGraph();
         std::string dumps(const nl::json& dict);
     private:
         nl::json getXtypesByURI(const std::string &graph, const std::string &uri, const std::string &classname="");
-        nl::json getXtypes(const std::string &graph, const std::string &classname="");
-        nl::json loadAndCheck(const std::string &fname, const fs::path &fpath, const std::string &classname);
+        nl::json getXtypes(const std::string &graph, const std::string &classname="", const std::set<std::string> &keys = {});
+        /// Visits the models of graph in the order of their file names (only those after the file name after, if given)
+        bool _forEach(const std::string &graph, const std::string &classname, const std::function<bool(nl::json &)> &visitor,
+                      const std::set<std::string> &keys = {}, const std::string &after = "");
+        /// Visits the models stored in files (file name -> path)
+        bool _forEach(const std::map<std::string, fs::path> &files, const std::string &classname, const std::function<bool(nl::json &)> &visitor,
+                      const std::set<std::string> &keys = {}, const std::string &after = "");
+        /// Parses and validates a stored model. If keys are given, only these top-level keys (plus uri, uuid and classname) are kept.
+        nl::json loadAndCheck(const std::string &fname, const fs::path &fpath, const std::string &classname, const std::set<std::string> &keys = {});
         nl::json _load(const std::string &uri, const std::string &classname = "");
-        nl::json _find(const std::string &classname, const nl::json &properties);
+        nl::json _find(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields = {});
+        nl::json _findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                             const std::size_t limit, const std::vector<std::string> &fields);
+        std::size_t _count(const std::string &classname, const nl::json &properties);
+        nl::json _groupCount(const std::string &classname, const std::string &property, const nl::json &properties);
+        void _findEach(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields,
+                       const std::function<void(const nl::json &)> &visitor);
+        nl::json _findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset,
+                           const std::string &cursor, const std::vector<std::string> &fields);
+        /// Returns the top-level keys which have to be parsed to match properties and to project to fields (empty: all)
+        static std::set<std::string> projectionKeys(const Query &query, const std::vector<std::string> &fields);
+        /// Returns the files of the models of classname whose edges match the edge conditions of the query (looked up in the adjacency index)
+        std::map<std::string, fs::path> _findSources(const std::string &classname, const Query &query);
+        nl::json _loadSubgraph(const std::string &uri, const int max_depth, const std::set<std::string> &relations);
+        nl::json _traverse(const std::string &uri, const std::set<std::string> &relations, const std::string &direction,
+                           const int max_depth, const bool depth_first, const bool uris_only);
         nl::json _findEdgesFrom(const std::vector<std::string> &uris);
         nl::json _findEdgesTo(const std::vector<std::string> &uris);
+        /// Returns the edges of all models grouped by their target: {<target uri>: {<source uri>: {<relation>: [edges]}}} (scans all models)
+        nl::json _scanEdgesTo();
         void _removeEdgesTo(const std::vector<std::string> &uris);
         bool _remove(const std::string &uri);
         bool _update(const nl::json &models);
+        bool _patch(const std::string &uri, const nl::json &patch);
         bool _store(const nl::json &xtype);
         bool _add(const nl::json &models);
         bool _clear();
     private:
+        /**
+         * @brief In-memory adjacency of a graph
+         * It is refreshed incrementally: Only the files which have been added or modified since the last use are parsed again.
+         */
+        struct Adjacency
+        {
+            struct Node
+            {
+                fs::path path;
+                decltype(fs::last_write_time(fs::path())) mtime;
+                std::uintmax_t size;
+                std::string uri;
+                std::string classname;
+                nl::json relations; ///< relation name -> outgoing edges (see models::edgesOf())
+            };
+            std::map<std::string, Node> nodes;                     ///< file name -> node
+            std::map<std::string, std::set<std::string>> incoming; ///< target uri -> file names of the sources
+
+            void insert(const std::string &fname, Node node);
+            void erase(const std::string &fname);
+            /// Returns the uris adjacent to uri (stored in file fname) via the passed relations (empty: all)
+            std::vector<std::string> neighbours(const std::string &uri, const std::string &fname, const std::set<std::string> &relations,
+                                                const bool out, const bool in) const;
+        };
+        /// Returns the up to date adjacency of graph. m_adjacency_mutex has to be locked by the caller.
+        Adjacency &adjacency(const std::string &graph);
+        /// Drops the node of uri from the adjacency of graph, so it is parsed again on the next use
+        void forgetAdjacency(const std::string &graph, const std::string &uri);
+
         std::string m_graph = ""; /**< Current working graph */
+        std::map<std::string, Adjacency> m_adjacency; /**< graph -> adjacency index */
+        std::mutex m_adjacency_mutex;
     };
 }
@@ -0,0 +1,34 @@
+#pragma once
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace nl = nlohmann;
+
+/**
+ * @brief Helpers on serialized models (nl::json) and the graph they span
+ * They do not access any database, so the default implementations of DbInterface and the backends share them.
+ */
+namespace xdbi::models
+{
+    /// Returns the outgoing edges stored in model (relation name -> edges with "source")
+    nl::json edgesOf(const nl::json &model);
+    /// Returns true if the edges of relation are followed when following relations (empty: all)
+    bool follows(const std::set<std::string> &relations, const std::string &relation);
+    /// Returns the target uris of the edges stored in model (only of the passed relations, if not empty)
+    std::vector<std::string> relatedUris(const nl::json &model, const std::set<std::string> &relations = {});
+    /**
+     * @brief Visits the uris reachable from uri breadth-first (or depth-first) and returns them in visiting order (the start first)
+     * Every uri is returned once, so cycles are cut. The neighbours of a uri are only asked for, if max_depth (negative: unlimited) is not reached yet.
+     * Depth-first with a max_depth asks again for the neighbours of a uri which is reached on a shorter path later on.
+     * @param neighbours: Returns the uris adjacent to the passed one (in the order in which they should be visited)
+     */
+    std::vector<std::string> traverseUris(const std::string &uri, const int max_depth, const bool depth_first,
+                                          const std::function<std::vector<std::string>(const std::string &)> &neighbours);
+    /// Returns only the passed fields and the uri of the model (or the complete model if fields is empty)
+    nl::json project(const nl::json &model, const std::vector<std::string> &fields);
+    /// Returns the patched model. Throws if the patch is invalid, changes uri, uuid or classname or if the model is stored in the flat format.
+    nl::json applyPatch(const nl::json &model, const nl::json &patch);
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "DbInterface.hpp"
+#include "NegativeCache.hpp"
+#include <chrono>
+#include <regex>
 
 using namespace xtypes;
 
@@ -13,6 +16,23 @@ namespace xdbi
      *  >Note: If you want to read from the main_interface as well you have to put it in the list of import interfaces, too.
      *  Every dependent XType will also be saved to the main interface. That way the main interface alway holds the
      *  complete dataset.
+     *  To skip import interfaces which certainly do not hold a uri, load() can consult their membership summaries (see DbInterface::getMembership()).
+     *  These are refreshed at most every "membership_ttl_ms" milliseconds (config, default: -1 = no filtering) and whenever something is
+     *  written through this MultiDbClient. NOTE: Uris which others add to an import interface are missed until its summary is refreshed.
+     *  Uris which could not be found in any import interface are remembered for "negative_cache_ttl_ms" milliseconds
+     *  (config, default: 0 = disabled; at most "negative_cache_size" entries, default: 10000). This cache is cleared by writes
+     *  through this MultiDbClient and whenever the generation of an import interface changes.
+     *  NOTE: Without membership summaries, uris which others add are reported as missing until their entries expire.
+     *  Optionally, the config may contain "routing" rules which map classname patterns (ECMAScript regex) to the names of the import servers
+     *  holding these classes, e.g. {"routing": [{"classname": "Hardware.*", "import_servers": ["hw_db"]}]}.
+     *  load(), find() and uris() with a classname then only query the import servers of the first matching rule.
+     *  Without a classname or without a matching rule, all import servers are queried.
+     *  If "deadline_ms" (config, default: -1 = no deadline) is given, load(), find() and uris() do not wait longer than that for
+     *  the import servers (incl. refreshing their membership summaries); the results of servers missing the deadline are skipped.
+     *  NOTE: The deadline has no effect when this MultiDbClient is called from a job on the shared Executor (e.g. by the async API of
+     *  DbInterface), because the Executor then calls the import servers inline, one after another (see Executor::submit()).
+     *  The overloads of loadSpec(), findSpecs() and uris() with a partial argument report whether that happened in the call.
+     *  Latency, error, timeout and hit counts of every import server are available via getStatistics().
      **/
     class MultiDbClient : public DbInterface
     {
@@ -30,25 +50,148 @@ namespace xdbi
         bool isReady() override;
 
         // First match semantics: Will return the first match in order of the import_interfaces list
+        // NOTE: load(), find() and uris() query all import interfaces concurrently
         XTypePtr load(const std::string &uri, const std::string &classname = "") override;
+        nl::json loadSpec(const std::string &uri, const std::string &classname = "") override;
+        /// Like loadSpec() but sets partial to true if import interfaces had to be skipped because they missed the deadline
+        nl::json loadSpec(const std::string &uri, const std::string &classname, bool &partial);
         bool clear() override;
         bool remove(const std::string &uri) override;
         bool add(std::vector<XTypePtr> xtypes, const int max_depth=-1) override;
         bool add(nl::json xtypes) override;
         bool update(std::vector<XTypePtr> xtypes, const int max_depth=-1) override;
         bool update(nl::json xtypes) override;
+        bool patch(const std::string &uri, const nl::json &patch) override;
+        // Collects the matching uris first and fetches every model only from the import interface owning it (same priority as load()).
+        // If only one import interface is routed, it is asked for the models at once.
         std::vector<XTypePtr> find(const std::string &classname="", const nl::json &properties=nl::json{}) override;
+        nl::json findSpecs(const std::string &classname="", const nl::json &properties=nl::json{}, const std::vector<std::string> &fields={}) override;
+        /// Like findSpecs() but sets partial to true if import interfaces had to be skipped because they missed the deadline
+        nl::json findSpecs(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields, bool &partial);
         std::set<std::string> uris(const std::string &classname="", const nl::json &properties=nl::json{}) override;
+        /// Like uris() but sets partial to true if import interfaces had to be skipped because they missed the deadline
+        std::set<std::string> uris(const std::string &classname, const nl::json &properties, bool &partial);
+        // Merges the edges of all import interfaces. The edges of a source are taken from its owner only (same priority as load()).
+        nl::json findEdgesFrom(const std::vector<std::string> &uris) override;
+        nl::json findEdgesTo(const std::vector<std::string> &uris) override;
+        void invalidateCaches() override;
+
+        /// Returns the call, error, timeout and hit counts as well as the mean latency of every import interface (keyed by name, see nameOf())
+        nl::json getStatistics();
+        void resetStatistics();
 
         // Getters for interfaces
         const DbInterfacePtr getMainInterface();
         std::vector< DbInterfacePtr > getImportInterfaces();
 
     private:
+        /** Calls f(interface) for every passed interface on the shared Executor and returns the futures in the same order
+         *  The interfaces with the lowest mean latency are submitted first. Latencies and errors are recorded in the statistics.
+         *  NOTE: f is copied into every job, so it must not capture anything by reference
+         */
+        template <typename F>
+        auto forEachInterface(const std::vector<DbInterfacePtr> &interfaces, const F &f) -> std::vector<std::future<std::invoke_result_t<const F &, DbInterfacePtr>>>
+        {
+            std::vector<std::future<std::invoke_result_t<const F &, DbInterfacePtr>>> results(interfaces.size());
+            for (const std::size_t i : this->bySpeed(interfaces))
+            {
+                results[i] = Executor::shared().submit([f, interface = interfaces[i], index = this->indexOf(interfaces[i]), statistics = this->statistics]() {
+                    const auto start = std::chrono::steady_clock::now();
+                    try
+                    {
+                        auto result = f(interface);
+                        statistics->record(index, std::chrono::steady_clock::now() - start, false);
+                        return result;
+                    }
+                    catch (...)
+                    {
+                        statistics->record(index, std::chrono::steady_clock::now() - start, true);
+                        throw;
+                    }
+                });
+            }
+            return results;
+        }
+
+        /// Waits for the result of interface until the deadline. Returns false and counts a timeout, if it is missed.
+        template <typename Future>
+        bool awaitResult(Future &result, const DbInterfacePtr &interface, const std::chrono::steady_clock::time_point &deadline)
+        {
+            if (deadline == std::chrono::steady_clock::time_point::max())
+            {
+                result.wait();
+                return true;
+            }
+            if (result.wait_until(deadline) == std::future_status::ready)
+                return true;
+            std::lock_guard<std::mutex> lock(statistics->mutex);
+            statistics->entries[this->indexOf(interface)].timeouts++;
+            return false;
+        }
+
+        /// Returns the point in time until which the import interfaces have to answer the current call
+        std::chrono::steady_clock::time_point deadline() const;
+        /// Returns the position of interface in import_interfaces
+        std::size_t indexOf(const DbInterfacePtr &interface) const;
+        /// Returns the configured name of interface or, if it has none, its position in import_servers
+        std::string nameOf(const DbInterfacePtr &interface) const;
+        /// Returns the positions in interfaces sorted by ascending mean latency
+        std::vector<std::size_t> bySpeed(const std::vector<DbInterfacePtr> &interfaces) const;
+        /// Counts a non-empty result of interface
+        void recordHit(const DbInterfacePtr &interface);
+
+        /// Returns the import interfaces which may hold instances of classname according to the routing rules (in the order of import_interfaces)
+        std::vector<DbInterfacePtr> routeFor(const std::string &classname) const;
+        /// Returns the routed import interfaces which may hold the passed uri (in the order of import_interfaces)
+        std::vector<DbInterfacePtr> candidatesFor(const std::string &uri, const std::string &classname, const std::chrono::steady_clock::time_point &until);
+        /// Merges findEdgesFrom() (from: true) or findEdgesTo() of all import interfaces, keeping only the edges of every source reported by its owner
+        nl::json findEdges(const std::vector<std::string> &uris, const bool from);
+        /** Refreshes all membership summaries which are older than membership_ttl, waiting for them until the deadline at most
+         *  Refreshes which miss the deadline keep running and are picked up by a later call. Until then, the interface is not filtered.
+         */
+        void refreshMemberships(const std::chrono::steady_clock::time_point &until);
+        /// Forces a refresh of all membership summaries on their next use
+        void invalidateMemberships();
+
         DbInterfacePtr main_interface;
         std::vector< DbInterfacePtr > import_interfaces;
         nl::json multi_config;
 
+        struct Route
+        {
+            std::regex classname;
+            std::set<std::string> import_servers;
+        };
+        std::vector<Route> routes;
+
+        /// Cached membership summaries of the import interfaces (same order as import_interfaces, nullptr if unknown)
+        std::vector<MembershipPtr> import_memberships;
+        std::vector<std::chrono::steady_clock::time_point> import_membership_updates;
+        /// Running refreshes of the summaries (invalid if there is none)
+        std::vector<std::shared_future<MembershipPtr>> import_membership_refreshes;
+        std::chrono::milliseconds membership_ttl{-1};
+        std::mutex membership_mutex;
+
+        NegativeCache unresolved;
+
+        struct InterfaceStatistics
+        {
+            std::size_t calls = 0;
+            std::size_t errors = 0;
+            std::size_t timeouts = 0;
+            std::size_t hits = 0;
+            std::chrono::duration<double, std::milli> latency{0};
+        };
+        /// Shared with the jobs on the Executor, because these may finish after a missed deadline
+        struct StatisticsTable
+        {
+            std::mutex mutex;
+            std::vector<InterfaceStatistics> entries;
+            void record(const std::size_t index, const std::chrono::steady_clock::duration &latency, const bool error);
+        };
+        std::shared_ptr<StatisticsTable> statistics;
+        std::chrono::milliseconds deadline_ms{-1};
+
     };
 
 }
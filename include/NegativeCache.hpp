@@ -0,0 +1,43 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace xdbi
+{
+    /**
+     * @brief A bounded, thread-safe cache of keys (e.g. uris) which could not be resolved
+     * Entries expire after the TTL. If the capacity is exceeded, the oldest entries are dropped first.
+     * NOTE: The cache is disabled by default (TTL 0), because it hides uris which others add until the entries expire.
+     */
+    class NegativeCache
+    {
+    public:
+        NegativeCache(const std::size_t capacity = 10000, const std::chrono::milliseconds ttl = std::chrono::milliseconds(0));
+
+        /// Remembers that the key could not be resolved
+        void insert(const std::string &key);
+        /// Returns true if the key is known to be unresolvable (and the entry has not expired yet)
+        bool contains(const std::string &key);
+        /// Forgets all entries
+        void clear();
+
+        void setCapacity(const std::size_t capacity);
+        /// Sets how long an entry stays valid. A TTL of 0 disables the cache.
+        void setTTL(const std::chrono::milliseconds ttl);
+
+    private:
+        using clock = std::chrono::steady_clock;
+        void evict();
+
+        std::size_t capacity;
+        std::chrono::milliseconds ttl;
+        /// key -> time of insertion
+        std::unordered_map<std::string, clock::time_point> entries;
+        /// keys in order of insertion (may contain outdated duplicates which are skipped on eviction)
+        std::deque<std::pair<std::string, clock::time_point>> insertion_order;
+        std::mutex mutex;
+    };
+}
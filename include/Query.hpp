@@ -0,0 +1,89 @@
+#pragma once
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace nl = nlohmann;
+
+namespace xdbi
+{
+    /**
+     * @brief A find() query compiled into an evaluator
+     * A query is an object which maps property paths to conditions. All of them have to hold.
+     * - A path is a property name or a dot-separated path into nested objects/arrays (e.g. "pose.position.x").
+     *   Paths are resolved in the properties of a model first and in the model itself second (e.g. "uri", "classname").
+     * - A condition is either a plain value (exact equality) or an object of operators:
+     *   $eq, $ne, $gt, $gte, $lt, $lte, $in, $nin, $prefix, $regex (with optional $options: "i"), $exists and $not
+     * - The top-level keys $and, $or (arrays of queries) and $not (a query) combine queries.
+     * - The key $edge (an object or an array of objects which all have to hold) requires an outgoing edge with
+     *   - "relation": the name of the relation (optional, default: any),
+     *   - "target": a condition on the target uri (optional) and
+     *   - "edge_properties": a query on the edge properties (optional).
+     * Example: {"mass": {"$gte": 1.0, "$lt": 5.0}, "$or": [{"name": {"$prefix": "arm"}}, {"type": {"$in": ["a", "b"]}}]}
+     * Example: {"$edge": {"relation": "has_part", "target": "some_uri", "edge_properties": {"weight": {"$gt": 1}}}}
+     */
+    class Query
+    {
+    public:
+        /// Compiles the query. Throws std::invalid_argument if it is malformed.
+        Query(const nl::json &query = nl::json::object());
+
+        /// Returns true if the (serialized) model satisfies the query
+        bool matches(const nl::json &model) const;
+        /// Returns the top-level keys of a model which are needed to evaluate the query (see complete())
+        const std::set<std::string> &keys() const { return m_keys; }
+        /// Returns true if the complete model is needed to evaluate the query (keys() is empty then)
+        bool complete() const { return m_complete; }
+        /// Returns the uris a model has to have to match (if the query restricts them), so the models can be looked up directly
+        const std::optional<std::set<std::string>> &uris() const { return m_uris; }
+        /// Returns true if the query has top-level edge conditions, so the candidates can be looked up in an adjacency index
+        bool constrainsRelations() const { return static_cast<bool>(m_relations); }
+        /// Returns true if the relations (relation name -> edges) satisfy the top-level edge conditions of the query
+        bool matchesRelations(const nl::json &relations) const;
+        /// Returns the value at path (see above) in the model or nullptr if there is none
+        static const nl::json *resolve(const nl::json &model, const std::string &path);
+
+    private:
+        /// Evaluates a model
+        using Predicate = std::function<bool(const nl::json &)>;
+        /// Evaluates the value at a path of a model (nullptr if there is none)
+        using ValuePredicate = std::function<bool(const nl::json *)>;
+        Predicate compile(const nl::json &query);
+        ValuePredicate compileCondition(const nl::json &condition);
+        ValuePredicate compileOperator(const std::string &op, const nl::json &operand, const nl::json &condition);
+        /// Compiles an $edge condition into a predicate over the relations of a model
+        Predicate compileEdges(const nl::json &edges);
+        Predicate m_predicate;
+        Predicate m_relations;
+        std::set<std::string> m_keys;
+        bool m_complete = false;
+        std::optional<std::set<std::string>> m_uris;
+    };
+
+    /**
+     * @brief The order of find() results given by sort keys
+     * A sort key is a path (see Query) which is sorted ascending or, if prefixed with '-', descending (e.g. {"-modified", "name"}).
+     * Models without a value come last. Ties are broken by the uri.
+     */
+    class SortOrder
+    {
+    public:
+        SortOrder(const std::vector<std::string> &sort);
+
+        /// Returns the values of the sort keys (and the uri) of the model
+        nl::json valuesOf(const nl::json &model) const;
+        /// Returns true if a model with the values a (see valuesOf()) comes before one with the values b
+        bool before(const nl::json &a, const nl::json &b) const;
+        /// Returns the top-level keys of a model which are needed to sort it
+        std::set<std::string> keys() const;
+        /// Returns the fields to fetch, so the models can be sorted and projected to fields afterwards (empty: the complete models)
+        std::vector<std::string> fieldsFor(const std::vector<std::string> &fields) const;
+
+    private:
+        /// path -> descending
+        std::vector<std::pair<std::string, bool>> m_sort;
+    };
+}
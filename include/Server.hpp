@@ -44,8 +44,20 @@ namespace xdbi {
         crow::response add(const crow::request &req, const nl::json& dbrequest);
         /// Callback for incoming update requests (calls are delegated by db_request()
         crow::response update(const crow::request &req, const nl::json& dbrequest);
+        /// Callback for incoming patch requests (calls are delegated by db_request()
+        crow::response patch(const crow::request &req, const nl::json& dbrequest);
         /// Callback for incoming find requests (calls are delegated by db_request()
         crow::response find(const crow::request &req, const nl::json& dbrequest);
+        /// Callback for incoming count requests (calls are delegated by db_request()
+        crow::response count(const crow::request &req, const nl::json& dbrequest);
+        /// Callback for incoming subgraph requests (calls are delegated by db_request()
+        crow::response subgraph(const crow::request &req, const nl::json& dbrequest);
+        /// Callback for incoming edges requests (calls are delegated by db_request()
+        crow::response edges(const crow::request &req, const nl::json& dbrequest);
+        /// Callback for incoming traverse requests (calls are delegated by db_request()
+        crow::response traverse(const crow::request &req, const nl::json& dbrequest);
+        /// Callback for incoming membership requests (calls are delegated by db_request()
+        crow::response membership(const crow::request &req, const nl::json& dbrequest);
         /// Callback for incoming ping requests (calls are delegated by db_request()
         crow::response ping(const crow::request &req,const nl::json &dbRequest);
 
@@ -24,14 +24,29 @@ namespace xdbi
         bool isReady() override;
 
         XTypePtr load(const std::string &uri, const std::string &classname = "") override;
+        nl::json loadSpec(const std::string &uri, const std::string &classname = "") override;
+        nl::json loadSubgraphSpecs(const std::string &uri, const int max_depth = -1, const std::set<std::string> &relations = {}) override;
         bool clear() override;
         bool remove(const std::string &uri) override;
         bool add(std::vector<XTypePtr> xtypes, const int max_depth=-1) override;
         bool add(nl::json xtypes) override;
         bool update(std::vector<XTypePtr> xtypes, const int max_depth=-1) override;
         bool update(nl::json xtypes) override;
+        bool patch(const std::string &uri, const nl::json &patch) override;
         std::vector<XTypePtr> find(const std::string &classname="", const nl::json &properties=nl::json{}) override;
+        nl::json findSpecs(const std::string &classname="", const nl::json &properties=nl::json{}, const std::vector<std::string> &fields={}) override;
+        nl::json findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset = 0,
+                          const std::string &cursor = "", const std::vector<std::string> &fields = {}) override;
         std::set<std::string> uris(const std::string &classname="", const nl::json &properties=nl::json{}) override;
+        nl::json findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                            const std::size_t limit = 0, const std::vector<std::string> &fields = {}) override;
+        std::size_t count(const std::string &classname="", const nl::json &properties=nl::json{}) override;
+        nl::json groupCount(const std::string &classname, const std::string &property, const nl::json &properties=nl::json{}) override;
+        nl::json findEdgesFrom(const std::vector<std::string> &uris) override;
+        nl::json findEdgesTo(const std::vector<std::string> &uris) override;
+        nl::json traverse(const std::string &uri, const std::set<std::string> &relations = {}, const std::string &direction = "out",
+                          const int max_depth = -1, const bool depth_first = false, const bool uris_only = false) override;
+        MembershipPtr getMembership(const MembershipPtr &known = nullptr) override;
 
     private:
         std::unique_ptr<JsonDatabaseBackend> backend;
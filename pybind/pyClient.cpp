@@ -17,10 +17,26 @@ void PYBIND11_INIT_CLASS_CLIENT(py::module_ &m)
         .def(py::init<const xtypes::XTypeRegistryPtr, const std::string, const std::string>(),
              py::arg("registry"), py::arg("dbAddress"), py::arg("graph"))
         .def("isReady", &Client::isReady)
+        .def("setIdentityMap", &Client::setIdentityMap,
+             py::arg("enabled"))
+        .def("setDirtyTracking", &Client::setDirtyTracking,
+             py::arg("enabled"))
         .def("setDbUser", &Client::setDbUser,
              py::arg("dbUser"))
         .def("setDbPassword", &Client::setDbPassword,
              py::arg("dbPassword"))
+        .def("setConnectionPoolSize", &Client::setConnectionPoolSize,
+             py::arg("size"))
+        .def("getConnectionPoolSize", &Client::getConnectionPoolSize)
+        .def("setReadinessTTL", &Client::setReadinessTTL,
+             py::arg("ttl_ms"))
+        .def("setRetryInterval", &Client::setRetryInterval,
+             py::arg("interval_ms"))
+        .def("startHealthCheck", &Client::startHealthCheck,
+             py::arg("interval_ms"))
+        .def("stopHealthCheck", &Client::stopHealthCheck)
+        .def("setNegativeCache", &Client::setNegativeCache,
+             py::arg("capacity"), py::arg("ttl_ms"))
 
         .def("setWorkingGraph", &Client::setWorkingGraph)
         .def("getWorkingGraph", &Client::getWorkingGraph)
@@ -29,6 +45,12 @@ void PYBIND11_INIT_CLASS_CLIENT(py::module_ &m)
         .def("getAbsoluteDbGraphPath", &Client::getAbsoluteDbGraphPath)
         .def("load", &Client::load,
              py::arg("uri"),  py::arg("classname") = "")
+        .def("loadSpec", &Client::loadSpec,
+             py::arg("uri"), py::arg("classname") = "")
+        .def("loadSubgraph", &Client::loadSubgraph,
+             py::arg("uri"), py::arg("max_depth") = -1, py::arg("relations") = std::set<std::string>())
+        .def("loadSubgraphSpecs", &Client::loadSubgraphSpecs,
+             py::arg("uri"), py::arg("max_depth") = -1, py::arg("relations") = std::set<std::string>())
         .def("clear", &Client::clear)
         .def("remove", &Client::remove,
              py::arg("uri"))
@@ -40,8 +62,29 @@ void PYBIND11_INIT_CLASS_CLIENT(py::module_ &m)
              py::arg("xtypes"), py::arg("max_depth")=-1)
         .def("update", py::overload_cast<nl::json>(&Client::update),
              py::arg("xtypes"))
+        .def("patch", &Client::patch,
+             py::arg("uri"), py::arg("patch"))
         .def("find", &Client::find,
              py::arg("classname") = "", py::arg("properties") = nl::json{})
+        .def("findSpecs", &Client::findSpecs,
+             py::arg("classname") = "", py::arg("properties") = nl::json{}, py::arg("fields") = std::vector<std::string>())
+        .def("findPage", &Client::findPage,
+             py::arg("classname"), py::arg("properties"), py::arg("limit"), py::arg("offset") = 0,
+             py::arg("cursor") = "", py::arg("fields") = std::vector<std::string>())
         .def("uris", &Client::uris,
-             py::arg("classname") = "", py::arg("properties") = nl::json{});
+             py::arg("classname") = "", py::arg("properties") = nl::json{})
+        .def("findSorted", &Client::findSorted,
+             py::arg("classname"), py::arg("properties"), py::arg("sort"), py::arg("limit") = 0,
+             py::arg("fields") = std::vector<std::string>())
+        .def("count", &Client::count,
+             py::arg("classname") = "", py::arg("properties") = nl::json{})
+        .def("groupCount", &Client::groupCount,
+             py::arg("classname"), py::arg("property"), py::arg("properties") = nl::json{})
+        .def("findEdgesFrom", &Client::findEdgesFrom,
+             py::arg("uris"))
+        .def("findEdgesTo", &Client::findEdgesTo,
+             py::arg("uris"))
+        .def("traverse", &Client::traverse,
+             py::arg("uri"), py::arg("relations") = std::set<std::string>(), py::arg("direction") = "out",
+             py::arg("max_depth") = -1, py::arg("depth_first") = false, py::arg("uris_only") = false);
 }
@@ -22,11 +22,34 @@ void PYBIND11_INIT_CLASS_JSONDATABASEBACKEND(py::module_ &m)
              py::arg("xtypes"))
       .def("find", py::overload_cast<const std::string&, const nl::json&>(&JsonDatabaseBackend::find),
            py::arg("classname"), py::arg("properties"))
+      .def("find", py::overload_cast<const std::string&, const nl::json&, const std::vector<std::string>&>(&JsonDatabaseBackend::find),
+           py::arg("classname"), py::arg("properties"), py::arg("fields"))
+      .def("findPage", &JsonDatabaseBackend::findPage,
+           py::arg("classname"), py::arg("properties"), py::arg("limit"), py::arg("offset") = 0,
+           py::arg("cursor") = "", py::arg("fields") = std::vector<std::string>())
       .def("remove", py::overload_cast<const std::string&>(&JsonDatabaseBackend::remove),
            py::arg("uri"))
+      .def("patch", &JsonDatabaseBackend::patch,
+           py::arg("uri"), py::arg("patch"))
       .def("clear", &JsonDatabaseBackend::clear)
       .def("load", py::overload_cast<const std::string&, const std::string&>(&JsonDatabaseBackend::load),
            py::arg("uri"), py::arg("classname"))
+      .def("loadSubgraph", &JsonDatabaseBackend::loadSubgraph,
+           py::arg("uri"), py::arg("max_depth") = -1, py::arg("relations") = std::set<std::string>())
+      .def("findSorted", &JsonDatabaseBackend::findSorted,
+           py::arg("classname"), py::arg("properties"), py::arg("sort"), py::arg("limit") = 0,
+           py::arg("fields") = std::vector<std::string>())
+      .def("count", &JsonDatabaseBackend::count,
+           py::arg("classname"), py::arg("properties") = nl::json{})
+      .def("groupCount", &JsonDatabaseBackend::groupCount,
+           py::arg("classname"), py::arg("property"), py::arg("properties") = nl::json{})
+      .def("findEdgesFrom", &JsonDatabaseBackend::findEdgesFrom,
+           py::arg("uris"))
+      .def("findEdgesTo", &JsonDatabaseBackend::findEdgesTo,
+           py::arg("uris"))
+      .def("traverse", &JsonDatabaseBackend::traverse,
+           py::arg("uri"), py::arg("relations") = std::set<std::string>(), py::arg("direction") = "out",
+           py::arg("max_depth") = -1, py::arg("depth_first") = false, py::arg("uris_only") = false)
       .def("setWorkingGraph", py::overload_cast<const std::string&>(&JsonDatabaseBackend::setWorkingGraph),
            py::arg("graph"))
       .def("dumps", py::overload_cast<const nl::json&>(&JsonDatabaseBackend::dumps),
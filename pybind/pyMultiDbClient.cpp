@@ -17,6 +17,8 @@ void PYBIND11_INIT_CLASS_MULTIDBCLIENT(py::module_ &m)
         .def(py::init<const xtypes::XTypeRegistryPtr, const nl::json &>(),
              py::arg("registry"), py::arg("config"))
         .def("isReady", &MultiDbClient::isReady)
+        .def("setIdentityMap", &MultiDbClient::setIdentityMap,
+             py::arg("enabled"))
 
         .def("setWorkingGraph", &MultiDbClient::setWorkingGraph)
         .def("getWorkingGraph", &MultiDbClient::getWorkingGraph)
@@ -24,6 +26,12 @@ void PYBIND11_INIT_CLASS_MULTIDBCLIENT(py::module_ &m)
         .def("getAbsoluteDbGraphPath", &MultiDbClient::getAbsoluteDbGraphPath)
         .def("load", &MultiDbClient::load,
              py::arg("uri"), py::arg("classname") = "")
+        .def("loadSpec", py::overload_cast<const std::string &, const std::string &>(&MultiDbClient::loadSpec),
+             py::arg("uri"), py::arg("classname") = "")
+        .def("loadSubgraph", &MultiDbClient::loadSubgraph,
+             py::arg("uri"), py::arg("max_depth") = -1, py::arg("relations") = std::set<std::string>())
+        .def("loadSubgraphSpecs", &MultiDbClient::loadSubgraphSpecs,
+             py::arg("uri"), py::arg("max_depth") = -1, py::arg("relations") = std::set<std::string>())
         .def("clear", &MultiDbClient::clear)
         .def("remove", &MultiDbClient::remove,
              py::arg("uri"))
@@ -35,10 +43,33 @@ void PYBIND11_INIT_CLASS_MULTIDBCLIENT(py::module_ &m)
              py::arg("xtypes"), py::arg("max_depth")=-1)
         .def("update", py::overload_cast<nl::json>(&MultiDbClient::update),
              py::arg("xtypes"))
+        .def("patch", &MultiDbClient::patch,
+             py::arg("uri"), py::arg("patch"))
         .def("find", &MultiDbClient::find,
              py::arg("classname") = "", py::arg("properties") = nl::json{})
-        .def("uris", &MultiDbClient::uris,
+        .def("findSpecs", py::overload_cast<const std::string &, const nl::json &, const std::vector<std::string> &>(&MultiDbClient::findSpecs),
+             py::arg("classname") = "", py::arg("properties") = nl::json{}, py::arg("fields") = std::vector<std::string>())
+        .def("findPage", &MultiDbClient::findPage,
+             py::arg("classname"), py::arg("properties"), py::arg("limit"), py::arg("offset") = 0,
+             py::arg("cursor") = "", py::arg("fields") = std::vector<std::string>())
+        .def("uris", py::overload_cast<const std::string &, const nl::json &>(&MultiDbClient::uris),
+             py::arg("classname") = "", py::arg("properties") = nl::json{})
+        .def("findSorted", &MultiDbClient::findSorted,
+             py::arg("classname"), py::arg("properties"), py::arg("sort"), py::arg("limit") = 0,
+             py::arg("fields") = std::vector<std::string>())
+        .def("count", &MultiDbClient::count,
              py::arg("classname") = "", py::arg("properties") = nl::json{})
+        .def("groupCount", &MultiDbClient::groupCount,
+             py::arg("classname"), py::arg("property"), py::arg("properties") = nl::json{})
+        .def("findEdgesFrom", &MultiDbClient::findEdgesFrom,
+             py::arg("uris"))
+        .def("findEdgesTo", &MultiDbClient::findEdgesTo,
+             py::arg("uris"))
+        .def("traverse", &MultiDbClient::traverse,
+             py::arg("uri"), py::arg("relations") = std::set<std::string>(), py::arg("direction") = "out",
+             py::arg("max_depth") = -1, py::arg("depth_first") = false, py::arg("uris_only") = false)
+        .def("getStatistics", &MultiDbClient::getStatistics)
+        .def("resetStatistics", &MultiDbClient::resetStatistics)
         .def("getImportInterfaces", &MultiDbClient::getMainInterface)
         .def("getMainInterface", &MultiDbClient::getMainInterface);
 }
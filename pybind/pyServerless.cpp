@@ -17,6 +17,10 @@ void PYBIND11_INIT_CLASS_SERVERLESS(py::module_ &m)
         .def(py::init<const xtypes::XTypeRegistryPtr, const std::string, const std::string>(),
              py::arg("registry"), py::arg("dbPath"), py::arg("graph"))
         .def("isReady", &Serverless::isReady)
+        .def("setIdentityMap", &Serverless::setIdentityMap,
+             py::arg("enabled"))
+        .def("setDirtyTracking", &Serverless::setDirtyTracking,
+             py::arg("enabled"))
 
         .def("setWorkingGraph", &Serverless::setWorkingGraph)
         .def("getWorkingGraph", &Serverless::getWorkingGraph)
@@ -26,6 +30,12 @@ void PYBIND11_INIT_CLASS_SERVERLESS(py::module_ &m)
         .def("getAbsoluteDbGraphPath", &Serverless::getAbsoluteDbGraphPath)
         .def("load", &Serverless::load,
              py::arg("uri"), py::arg("classname") = "")
+        .def("loadSpec", &Serverless::loadSpec,
+             py::arg("uri"), py::arg("classname") = "")
+        .def("loadSubgraph", &Serverless::loadSubgraph,
+             py::arg("uri"), py::arg("max_depth") = -1, py::arg("relations") = std::set<std::string>())
+        .def("loadSubgraphSpecs", &Serverless::loadSubgraphSpecs,
+             py::arg("uri"), py::arg("max_depth") = -1, py::arg("relations") = std::set<std::string>())
         .def("clear", &Serverless::clear)
         .def("remove", &Serverless::remove,
              py::arg("uri"))
@@ -37,8 +47,29 @@ void PYBIND11_INIT_CLASS_SERVERLESS(py::module_ &m)
              py::arg("xtypes"), py::arg("max_depth")=-1)
         .def("update", py::overload_cast<nl::json>(&Serverless::update),
              py::arg("xtypes"))
+        .def("patch", &Serverless::patch,
+             py::arg("uri"), py::arg("patch"))
         .def("find", &Serverless::find,
              py::arg("classname") = "", py::arg("properties") = nl::json{})
+        .def("findSpecs", &Serverless::findSpecs,
+             py::arg("classname") = "", py::arg("properties") = nl::json{}, py::arg("fields") = std::vector<std::string>())
+        .def("findPage", &Serverless::findPage,
+             py::arg("classname"), py::arg("properties"), py::arg("limit"), py::arg("offset") = 0,
+             py::arg("cursor") = "", py::arg("fields") = std::vector<std::string>())
         .def("uris", &Serverless::uris,
-             py::arg("classname") = "", py::arg("properties") = nl::json{});
+             py::arg("classname") = "", py::arg("properties") = nl::json{})
+        .def("findSorted", &Serverless::findSorted,
+             py::arg("classname"), py::arg("properties"), py::arg("sort"), py::arg("limit") = 0,
+             py::arg("fields") = std::vector<std::string>())
+        .def("count", &Serverless::count,
+             py::arg("classname") = "", py::arg("properties") = nl::json{})
+        .def("groupCount", &Serverless::groupCount,
+             py::arg("classname"), py::arg("property"), py::arg("properties") = nl::json{})
+        .def("findEdgesFrom", &Serverless::findEdgesFrom,
+             py::arg("uris"))
+        .def("findEdgesTo", &Serverless::findEdgesTo,
+             py::arg("uris"))
+        .def("traverse", &Serverless::traverse,
+             py::arg("uri"), py::arg("relations") = std::set<std::string>(), py::arg("direction") = "out",
+             py::arg("max_depth") = -1, py::arg("depth_first") = false, py::arg("uris_only") = false);
  }
@@ -7,6 +7,22 @@ using namespace xtypes;
 using namespace xdbi;
 namespace nl = nlohmann;
 
+struct xdbi::Client::SessionLease
+{
+    SessionLease(Client &client)
+        : client(client), session(client.acquireSession())
+    {
+    }
+    ~SessionLease()
+    {
+        client.releaseSession(std::move(session));
+    }
+    cpr::Session *operator->() { return session.get(); }
+
+    Client &client;
+    std::unique_ptr<cpr::Session> session;
+};
+
 xdbi::Client::Client(const XTypeRegistryPtr registry, const std::string &dbAddress, const std::string graph)
     : DbInterface(registry)
 {
@@ -15,35 +31,205 @@ xdbi::Client::Client(const XTypeRegistryPtr registry, const std::string &dbAddre
     this->setDbAddress(dbAddress);
 }
 
+xdbi::Client::~Client()
+{
+    this->stopHealthCheck();
+}
+
+std::unique_ptr<cpr::Session> xdbi::Client::acquireSession()
+{
+    std::unique_lock<std::mutex> lock(sessionsMutex);
+    sessionAvailable.wait(lock, [&] { return !idleSessions.empty() || openSessions < poolSize; });
+    if (!idleSessions.empty())
+    {
+        std::unique_ptr<cpr::Session> session = std::move(idleSessions.back());
+        idleSessions.pop_back();
+        return session;
+    }
+    // Open a new session. It keeps its connection alive, so subsequent requests can reuse it.
+    // The slot is reserved before, so no other thread exceeds the pool size meanwhile.
+    openSessions++;
+    lock.unlock();
+    try
+    {
+        auto session = std::make_unique<cpr::Session>();
+        session->SetHeader(cpr::Header{{"content-type", "application/json"}});
+        return session;
+    }
+    catch (...)
+    {
+        // Give the slot back, otherwise the pool would shrink for good
+        lock.lock();
+        openSessions--;
+        lock.unlock();
+        sessionAvailable.notify_one();
+        throw;
+    }
+}
+
+void xdbi::Client::releaseSession(std::unique_ptr<cpr::Session> session)
+{
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        // If the pool has been shrunk in the meantime, we drop the session instead of returning it
+        if (openSessions > poolSize)
+            openSessions--;
+        else
+            idleSessions.push_back(std::move(session));
+    }
+    sessionAvailable.notify_one();
+}
+
+void xdbi::Client::setConnectionPoolSize(const std::size_t size)
+{
+    if (size < 1)
+        throw std::invalid_argument("Client::setConnectionPoolSize(): size has to be at least 1");
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        poolSize = size;
+        while (openSessions > poolSize && !idleSessions.empty())
+        {
+            idleSessions.pop_back();
+            openSessions--;
+        }
+    }
+    sessionAvailable.notify_all();
+}
+
+std::size_t xdbi::Client::getConnectionPoolSize()
+{
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    return poolSize;
+}
+
+nl::json xdbi::Client::request(const nl::json &dbRequest, const std::string &caller)
+{
+    cpr::Response r;
+    {
+        SessionLease session(*this);
+        session->SetUrl(cpr::Url(dbAddress + "/"));
+        session->SetBody(cpr::Body{dbRequest.dump()});
+        r = session->Post();
+    }
+    this->updateReadiness(r.status_code != 0);
+    if (r.status_code == 0)
+    {
+        throw std::runtime_error("Client::" + caller + "(): No response from server. Is it running?");
+    }
+    return xtypes::parseJson(r.text);
+}
+
 std::time_t xdbi::Client::ping()
-  {
+{
     struct timeval time_now{};
     gettimeofday(&time_now, nullptr);
     const std::time_t msecs_time = (time_now.tv_sec * 1000) + (time_now.tv_usec / 1000);
 
-      nl::json dbRequest;
-      dbRequest["type"] = "ping";
+    nl::json dbRequest;
+    dbRequest["type"] = "ping";
     dbRequest["time"] = msecs_time;
     dbRequest["graph"] = getWorkingGraph();
-      cpr::Response response = cpr::Post(cpr::Url(dbAddress + "/"),
-                                         cpr::Body{{dbRequest.dump()}},
-                                         cpr::Header{{"content-type", "application/json"}});
-    if(response.status_code == 0) return -1;
+    cpr::Response response;
+    {
+        SessionLease session(*this);
+        session->SetUrl(cpr::Url(dbAddress + "/"));
+        session->SetBody(cpr::Body{dbRequest.dump()});
+        response = session->Post();
+    }
+    if(response.status_code == 0)
+    {
+        this->updateReadiness(false);
+        return -1;
+    }
     const nl::json r = nl::json::parse(response.text);
-    if(r["status"].get<std::string>() == "finished")
+    const bool finished = r["status"].get<std::string>() == "finished";
+    this->updateReadiness(finished);
+    if(finished)
         return r["result"].get<std::int64_t>();
     else
         return -1;
+}
+
+void xdbi::Client::updateReadiness(const bool reachable)
+{
+    this->reachable = reachable;
+    this->lastContact = std::chrono::steady_clock::now();
+}
+
+bool xdbi::Client::isUnsupported(const nl::json &response)
+{
+    // See Server::db_request()
+    static const std::string unsupported = "Unsupported request type";
+    return response.value("status", std::string()) == "error" && response.value("message", std::string()).rfind(unsupported, 0) == 0;
+}
+
+void xdbi::Client::setReadinessTTL(const std::time_t ttl_ms)
+{
+    this->readinessTTL = ttl_ms;
+}
+
+void xdbi::Client::setRetryInterval(const std::time_t interval_ms)
+{
+    this->retryInterval = interval_ms;
+}
+
+void xdbi::Client::startHealthCheck(const std::time_t interval_ms)
+{
+    if (interval_ms <= 0)
+        throw std::invalid_argument("Client::startHealthCheck(): interval_ms has to be positive");
+    this->stopHealthCheck();
+    {
+        std::lock_guard<std::mutex> lock(healthCheckMutex);
+        healthCheckRunning = true;
+    }
+    healthCheckThread = std::thread([this, interval_ms] {
+        std::unique_lock<std::mutex> lock(healthCheckMutex);
+        while (!healthCheckStopped.wait_for(lock, std::chrono::milliseconds(interval_ms), [this] { return !healthCheckRunning; }))
+        {
+            lock.unlock();
+            this->ping();
+            lock.lock();
+        }
+    });
+}
+
+void xdbi::Client::stopHealthCheck()
+{
+    {
+        std::lock_guard<std::mutex> lock(healthCheckMutex);
+        healthCheckRunning = false;
+    }
+    healthCheckStopped.notify_all();
+    if (healthCheckThread.joinable())
+        healthCheckThread.join();
+}
 
-  }
-  
 bool xdbi::Client::isReady()
 {
-   return this->ping() != -1 && this->getWorkingGraph() != "";
+    if (this->getWorkingGraph() == "")
+        return false;
+    // Only a recent successful contact is trusted. Otherwise we ping, which also updates the readiness.
+    const auto age = std::chrono::steady_clock::now() - this->lastContact.load();
+    if (this->reachable && age < std::chrono::milliseconds(this->readinessTTL.load()))
+        return true;
+    return this->ping() != -1;
+}
+
+void xdbi::Client::checkReadiness()
+{
+    if (this->getWorkingGraph() == "")
+        throw std::runtime_error("ERROR: Tried to use a DbInterface that is not ready");
+    // A server which did not answer is only asked again after the (short) retry interval.
+    // Otherwise the request itself tells whether the server is reachable (and updates the readiness), so we do not ping before it.
+    const auto age = std::chrono::steady_clock::now() - this->lastContact.load();
+    if (!this->reachable && age < std::chrono::milliseconds(this->retryInterval.load()))
+        throw std::runtime_error("ERROR: Tried to use a DbInterface that is not ready");
 }
 
 void xdbi::Client::setDbAddress(const std::string& _dbAddress) {
     this->dbAddress = (_dbAddress.back() == '/' ? _dbAddress.substr(0, _dbAddress.size()-1) : _dbAddress);
+    this->reachable = false;
+    this->forgetSynced();
     if (!this->isReady())
         std::cerr << "Couldn't connect to the server at " << this->dbAddress << ". Is it running and the graph name set?" << std::endl;
 }
@@ -61,6 +247,19 @@ void xdbi::Client::setDbPassword(const std::string &_dbPassword)
 void xdbi::Client::setWorkingGraph(const std::string &graph)
 {
     workingGraph = graph;
+    this->invalidateCaches();
+    this->forgetSynced();
+}
+
+void xdbi::Client::setNegativeCache(const std::size_t capacity, const std::time_t ttl_ms)
+{
+    unresolved.setCapacity(capacity);
+    unresolved.setTTL(std::chrono::milliseconds(ttl_ms));
+}
+
+void xdbi::Client::invalidateCaches()
+{
+    unresolved.clear();
 }
 
 std::string xdbi::Client::getWorkingGraph()
@@ -86,23 +285,44 @@ std::string xdbi::Client::getAbsoluteDbPath()
 }
 
 XTypePtr xdbi::Client::load(const std::string &uri, const std::string &classname)
+{
+    return this->importSpec(this->loadSpec(uri, classname));
+}
+
+nl::json xdbi::Client::loadSpec(const std::string &uri, const std::string &classname)
 {
     this->checkReadiness();
+    if (unresolved.contains(uri))
+        return nl::json();
 
     nl::json dbRequest;
     dbRequest["graph"] = getWorkingGraph();
     dbRequest["type"] = "load";
     dbRequest["uri"] = uri;
-    const auto r = cpr::Post(cpr::Url(dbAddress + "/"),
-                       cpr::Body{{dbRequest.dump()}},
-                       cpr::Header{{"content-type", "application/json"}});
-    if (r.status_code == 0)
+    const nl::json response = this->request(dbRequest, "load");
+    if (response["status"].get<std::string>() == "finished" && response["result"].empty())
+        unresolved.insert(uri);
+    return response["result"];
+}
+
+nl::json xdbi::Client::loadSubgraphSpecs(const std::string &uri, const int max_depth, const std::set<std::string> &relations)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "subgraph";
+    dbRequest["uri"] = uri;
+    dbRequest["max_depth"] = max_depth;
+    dbRequest["relations"] = relations;
+    const nl::json response = this->request(dbRequest, "loadSubgraph");
+    if (response["status"].get<std::string>() != "finished")
     {
-        throw std::runtime_error("Client::load() No response from server. Is it running?");
+        // Servers which do not know subgraph requests yet are handled by one request per model
+        if (isUnsupported(response))
+            return DbInterface::loadSubgraphSpecs(uri, max_depth, relations);
+        throw std::runtime_error("Client::loadSubgraphSpecs(): " + response.value("message", std::string("Unknown error")));
     }
-    nl::json spec = xtypes::parseJson(r.text)["result"];
-
-    return XType::import_from(spec, registry.lock());
+    return response["result"];
 }
 
 bool xdbi::Client::clear()
@@ -112,15 +332,10 @@ bool xdbi::Client::clear()
     nl::json dbRequest;
     dbRequest["graph"] = getWorkingGraph();
     dbRequest["type"] = "clear";
+    this->forgetSynced();
 
-    cpr::Response r = cpr::Post(cpr::Url(dbAddress + "/"),
-                                cpr::Body{{dbRequest.dump()}},
-                                cpr::Header{{"content-type", "application/json"}});
-    if (r.status_code == 0)
-    {
-        throw std::runtime_error("Client::clear(): No response from server. Is it running?");
-    }
-    const nl::json response = xtypes::parseJson(r.text);
+    const nl::json response = this->request(dbRequest, "clear");
+    this->invalidateCaches();
     return response["status"].get<std::string>() == "finished";
 }
 
@@ -132,14 +347,10 @@ bool xdbi::Client::remove(const std::string &uri)
     dbRequest["graph"] = getWorkingGraph();
     dbRequest["type"] = "remove";
     dbRequest["uri"] = uri;
-    cpr::Response r = cpr::Post(cpr::Url(dbAddress + "/"),
-                                cpr::Body{{dbRequest.dump()}},
-                                cpr::Header{{"content-type", "application/json"}});
-    if (r.status_code == 0)
-    {
-        throw std::runtime_error("Client::remove(): No response from server. Is it running?");
-    }
-    const nl::json response = xtypes::parseJson(r.text);
+    // Removing might cascade to other models due to their delete policies
+    this->forgetSynced();
+    const nl::json response = this->request(dbRequest, "remove");
+    this->invalidateCaches();
     return response["status"].get<std::string>() == "finished";
 }
 
@@ -151,14 +362,9 @@ bool xdbi::Client::add(nl::json xtypes)
     dbRequest["graph"] = getWorkingGraph();
     dbRequest["type"] = "add";
     dbRequest["models"] = xtypes;
-    cpr::Response r = cpr::Post(cpr::Url(dbAddress + "/"),
-                                cpr::Body{{dbRequest.dump()}},
-                                cpr::Header{{"content-type", "application/json"}});
-    if (r.status_code == 0)
-    {
-        throw std::runtime_error("Client::add(): No response from server. Is it running?");
-    }
-    const nl::json response = xtypes::parseJson(r.text);
+    this->forgetSynced(xtypes);
+    const nl::json response = this->request(dbRequest, "add");
+    this->invalidateCaches();
     return response["status"].get<std::string>() == "finished";
 }
 
@@ -166,16 +372,7 @@ bool xdbi::Client::add(std::vector<XTypePtr> xtypes, const int max_depth)
 {
     this->checkReadiness();
     this->checkWriteable();
-    nl::json models;
-    for (auto xtype : xtypes)
-    {
-        std::map< std::string, nl::json> specs = xtype->export_to(max_depth);
-        for (const auto &[_,spec] : specs)
-        {
-            models.push_back(spec);
-        }
-    }
-    return this->add(models);
+    return this->add(this->exportSpecs(xtypes, max_depth));
 }
 
 bool xdbi::Client::update(nl::json xtypes)
@@ -187,14 +384,9 @@ bool xdbi::Client::update(nl::json xtypes)
     dbRequest["graph"] = getWorkingGraph();
     dbRequest["type"] = "update";
     dbRequest["models"] = xtypes;
-    cpr::Response r = cpr::Post(cpr::Url(dbAddress + "/"),
-                                cpr::Body{{dbRequest.dump()}},
-                                cpr::Header{{"content-type", "application/json"}});
-    if (r.status_code == 0)
-    {
-        throw std::runtime_error("Client::update(): No response from server. Is it running?");
-    }
-    const nl::json response = xtypes::parseJson(r.text);
+    this->forgetSynced(xtypes);
+    const nl::json response = this->request(dbRequest, "update");
+    this->invalidateCaches();
     return response["status"].get<std::string>() == "finished";
 }
 
@@ -202,41 +394,78 @@ bool xdbi::Client::update(std::vector<XTypePtr> xtypes, const int max_depth)
 {
     this->checkReadiness();
     this->checkWriteable();
-    nl::json models;
-    for (const auto &xtype : xtypes)
-    {
-        std::map< std::string, nl::json> specs = xtype->export_to(max_depth);
-        for (const auto &[_,spec] : specs)
-        {
-            models.push_back(spec);
-        }
-    }
+    // Only the models which changed since they have been loaded or written are sent
+    const nl::json models = this->dropUnchanged(this->exportSpecs(xtypes, max_depth));
+    if (models.empty())
+        return true;
+    // The stored models might differ from the written ones (e.g. by merging), so they are only synced again by the next load
     return this->update(models);
 }
 
-std::vector<XTypePtr> xdbi::Client::find(const std::string &classname, const nl::json &properties)
+bool xdbi::Client::patch(const std::string &uri, const nl::json &patch)
 {
     this->checkReadiness();
+    this->checkWriteable();
     nl::json dbRequest;
     dbRequest["graph"] = getWorkingGraph();
-    dbRequest["type"] = "find";
-    dbRequest["classname"] = classname;
-    dbRequest["properties"] = properties;
-    cpr::Response r = cpr::Post(cpr::Url(dbAddress + "/"),
-                                cpr::Body{{dbRequest.dump()}},
-                                cpr::Header{{"content-type", "application/json"}});
-    if (r.status_code == 0)
-    {
-        throw std::runtime_error("Client::find(): No response from server. Is it running?");
-    }
-    const nl::json models = xtypes::parseJson(r.text)["result"];
+    dbRequest["type"] = "patch";
+    dbRequest["uri"] = uri;
+    dbRequest["patch"] = patch;
+    this->forgetSynced(nl::json::array({{{"uri", uri}}}));
+    const nl::json response = this->request(dbRequest, "patch");
+    this->invalidateCaches();
+    if (response["status"].get<std::string>() != "finished")
+        throw std::runtime_error("Client::patch(): " + response.value("message", std::string("Unknown error")));
+    return response["result"].get<bool>();
+}
+
+std::vector<XTypePtr> xdbi::Client::find(const std::string &classname, const nl::json &properties)
+{
+    // The server already sends the complete models, so we import them directly instead of loading each one again
+    const nl::json models = this->findSpecs(classname, properties);
     std::vector<XTypePtr> out;
     out.reserve(models.size());
     std::transform(models.begin(), models.end(), std::back_inserter(out), [&](const nl::json &model)
-                   { return this->load(model["uri"], model["classname"]); });
+                   { return this->importSpec(model); });
     return out;
 }
 
+nl::json xdbi::Client::findSpecs(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "find";
+    dbRequest["classname"] = classname;
+    dbRequest["properties"] = properties;
+    if (!fields.empty())
+        dbRequest["fields"] = fields;
+    const nl::json response = this->request(dbRequest, "find");
+    return response["result"];
+}
+
+nl::json xdbi::Client::findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset,
+                                const std::string &cursor, const std::vector<std::string> &fields)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "find";
+    dbRequest["classname"] = classname;
+    dbRequest["properties"] = properties;
+    dbRequest["limit"] = limit;
+    dbRequest["offset"] = offset;
+    dbRequest["cursor"] = cursor;
+    if (!fields.empty())
+        dbRequest["fields"] = fields;
+    const nl::json response = this->request(dbRequest, "findPage");
+    // An error must not look like the last page, otherwise paging loops would silently stop early
+    if (response["status"].get<std::string>() != "finished")
+        throw std::runtime_error("Client::findPage(): " + response.value("message", std::string("Unknown error")));
+    // Older servers ignore the limit and send everything at once (without a cursor)
+    return {{"models", response["result"]}, {"cursor", response.value("cursor", std::string())}};
+}
+
 std::set<std::string> xdbi::Client::uris(const std::string &classname, const nl::json &properties)
 {
     this->checkReadiness();
@@ -245,16 +474,152 @@ std::set<std::string> xdbi::Client::uris(const std::string &classname, const nl:
     dbRequest["type"] = "find";
     dbRequest["classname"] = classname;
     dbRequest["properties"] = properties;
-    cpr::Response r = cpr::Post(cpr::Url(dbAddress + "/"),
-                                cpr::Body{{dbRequest.dump()}},
-                                cpr::Header{{"content-type", "application/json"}});
-    if (r.status_code == 0)
-    {
-        throw std::runtime_error("Client::find(): No response from server. Is it running?");
-    }
-    const nl::json models = xtypes::parseJson(r.text)["result"];
+    // The server only sends the uris instead of the complete models
+    dbRequest["fields"] = {"uri"};
+    const nl::json response = this->request(dbRequest, "uris");
+    const nl::json models = response["result"];
     std::set<std::string> results;
     std::transform(models.begin(), models.end(), std::inserter(results, results.begin()), [&](const nl::json &model)
                    { return model["uri"]; });
     return results;
 }
+
+nl::json xdbi::Client::findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                                  const std::size_t limit, const std::vector<std::string> &fields)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "find";
+    dbRequest["classname"] = classname;
+    dbRequest["properties"] = properties;
+    dbRequest["sort"] = sort;
+    dbRequest["limit"] = limit;
+    if (!fields.empty())
+        dbRequest["fields"] = fields;
+    const nl::json response = this->request(dbRequest, "findSorted");
+    if (response["status"].get<std::string>() != "finished")
+        throw std::runtime_error("Client::findSorted(): " + response.value("message", std::string("Unknown error")));
+    // Servers which do not know sort keys ignore them and answer with a page or all models instead, so we sort ourselves
+    if (!response.value("sorted", false))
+        return DbInterface::findSorted(classname, properties, sort, limit, fields);
+    return response["result"];
+}
+
+std::size_t xdbi::Client::count(const std::string &classname, const nl::json &properties)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "count";
+    dbRequest["classname"] = classname;
+    dbRequest["properties"] = properties;
+    const nl::json response = this->request(dbRequest, "count");
+    if (response["status"].get<std::string>() != "finished")
+    {
+        // Servers which do not know count requests yet are handled by counting the uris
+        if (isUnsupported(response))
+            return DbInterface::count(classname, properties);
+        throw std::runtime_error("Client::count(): " + response.value("message", std::string("Unknown error")));
+    }
+    return response["result"].get<std::size_t>();
+}
+
+nl::json xdbi::Client::groupCount(const std::string &classname, const std::string &property, const nl::json &properties)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "count";
+    dbRequest["classname"] = classname;
+    dbRequest["properties"] = properties;
+    dbRequest["group_by"] = property;
+    const nl::json response = this->request(dbRequest, "groupCount");
+    if (response["status"].get<std::string>() != "finished")
+    {
+        if (isUnsupported(response))
+            return DbInterface::groupCount(classname, property, properties);
+        throw std::runtime_error("Client::groupCount(): " + response.value("message", std::string("Unknown error")));
+    }
+    return response["result"];
+}
+
+nl::json xdbi::Client::findEdgesFrom(const std::vector<std::string> &uris)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "edges";
+    dbRequest["direction"] = "from";
+    dbRequest["uris"] = uris;
+    const nl::json response = this->request(dbRequest, "findEdgesFrom");
+    if (response["status"].get<std::string>() != "finished")
+    {
+        // Servers which do not know edge requests yet are handled by loading the models
+        if (isUnsupported(response))
+            return DbInterface::findEdgesFrom(uris);
+        throw std::runtime_error("Client::findEdgesFrom(): " + response.value("message", std::string("Unknown error")));
+    }
+    return response["result"];
+}
+
+nl::json xdbi::Client::findEdgesTo(const std::vector<std::string> &uris)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "edges";
+    dbRequest["direction"] = "to";
+    dbRequest["uris"] = uris;
+    const nl::json response = this->request(dbRequest, "findEdgesTo");
+    if (response["status"].get<std::string>() != "finished")
+    {
+        if (isUnsupported(response))
+            return DbInterface::findEdgesTo(uris);
+        throw std::runtime_error("Client::findEdgesTo(): " + response.value("message", std::string("Unknown error")));
+    }
+    return response["result"];
+}
+
+nl::json xdbi::Client::traverse(const std::string &uri, const std::set<std::string> &relations, const std::string &direction,
+                                const int max_depth, const bool depth_first, const bool uris_only)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "traverse";
+    dbRequest["uri"] = uri;
+    dbRequest["relations"] = relations;
+    dbRequest["direction"] = direction;
+    dbRequest["max_depth"] = max_depth;
+    dbRequest["order"] = depth_first ? "dfs" : "bfs";
+    dbRequest["uris_only"] = uris_only;
+    const nl::json response = this->request(dbRequest, "traverse");
+    if (response["status"].get<std::string>() != "finished")
+    {
+        // Servers which do not know traverse requests yet are handled by one edge request per visited uri
+        if (isUnsupported(response))
+            return DbInterface::traverse(uri, relations, direction, max_depth, depth_first, uris_only);
+        throw std::runtime_error("Client::traverse(): " + response.value("message", std::string("Unknown error")));
+    }
+    return response["result"];
+}
+
+MembershipPtr xdbi::Client::getMembership(const MembershipPtr &known)
+{
+    this->checkReadiness();
+    nl::json dbRequest;
+    dbRequest["graph"] = getWorkingGraph();
+    dbRequest["type"] = "membership";
+    if (known && known->graph == getWorkingGraph())
+        dbRequest["generation"] = known->generation;
+    const nl::json response = this->request(dbRequest, "getMembership");
+    // Servers which do not know membership requests answer with an error
+    if (response["status"].get<std::string>() != "finished")
+        return nullptr;
+    // Someone changed the graph, so previously unresolved uris might exist now
+    const std::size_t generation = response["result"]["generation"].get<std::size_t>();
+    if (lastGeneration.exchange(generation) != generation)
+        this->invalidateCaches();
+    return this->parseMembership(getWorkingGraph(), response["result"], known);
+}
@@ -3,9 +3,13 @@
 #include "Serverless.hpp"
 #include "Client.hpp"
 #include "MultiDbClient.hpp"
+#include "Query.hpp"
+#include "Models.hpp"
 
 #include <xtypes_generator/utils.hpp>
 
+#include <algorithm>
+
 using namespace xtypes;
 using namespace xdbi;
 
@@ -46,6 +50,401 @@ void xdbi::DbInterface::checkWriteable()
     }
 }
 
+bool xdbi::Membership::mayContain(const std::string &uri) const
+{
+    return uuids.count(std::to_string(xtypes::uri_to_uuid(uri))) > 0;
+}
+
+MembershipPtr xdbi::DbInterface::getMembership(const MembershipPtr &)
+{
+    return nullptr;
+}
+
+MembershipPtr xdbi::DbInterface::parseMembership(const std::string &graph, const nl::json &summary, const MembershipPtr &known)
+{
+    const std::size_t generation = summary["generation"].get<std::size_t>();
+    if (known && known->graph == graph && known->generation == generation)
+        return known;
+    if (!summary.contains("uuids"))
+        throw std::runtime_error("DbInterface::parseMembership(): summary of generation " + std::to_string(generation) + " has no uuids");
+    auto membership = std::make_shared<Membership>();
+    membership->graph = graph;
+    membership->generation = generation;
+    for (const auto &uuid : summary["uuids"])
+    {
+        membership->uuids.insert(uuid.get<std::string>());
+    }
+    return membership;
+}
+
+std::recursive_mutex &xdbi::DbInterface::registryMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+XTypePtr xdbi::DbInterface::importSpec(const nl::json &spec)
+{
+    if (spec.empty())
+        return nullptr;
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    if (dirty_tracking)
+        synced[spec["uri"].get<std::string>()] = std::hash<nl::json>{}(spec);
+    if (!use_identity_map)
+        return XType::import_from(spec, registry.lock());
+
+    // The hash of the model acts as its generation: Whenever the stored model changes, a new instance gets imported
+    const std::string uri = spec["uri"].get<std::string>();
+    const std::size_t spec_hash = std::hash<nl::json>{}(spec);
+    auto it = identities.find(uri);
+    if (it != identities.end() && it->second.spec_hash == spec_hash)
+    {
+        if (XTypePtr existing = it->second.instance.lock())
+            return existing;
+    }
+    XTypePtr xtype = XType::import_from(spec, registry.lock());
+    identities[uri] = Identity{spec_hash, xtype};
+    // Drop the entries of instances which are gone, whenever the map has doubled in size
+    if (identities.size() >= identities_prune_at)
+    {
+        for (auto entry = identities.begin(); entry != identities.end();)
+        {
+            if (entry->second.instance.expired())
+                entry = identities.erase(entry);
+            else
+                ++entry;
+        }
+        identities_prune_at = std::max<std::size_t>(1024, 2 * identities.size());
+    }
+    return xtype;
+}
+
+XTypePtr xdbi::DbInterface::loadSubgraph(const std::string &uri, const int max_depth, const std::set<std::string> &relations)
+{
+    const nl::json models = this->loadSubgraphSpecs(uri, max_depth, relations);
+    if (models.empty())
+        return nullptr;
+    // We import the leaves first, so that the facts of their sources can be resolved from the registry
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    XTypePtr root;
+    for (auto model = models.rbegin(); model != models.rend(); ++model)
+    {
+        root = this->importSpec(*model);
+    }
+    return root;
+}
+
+nl::json xdbi::DbInterface::loadSubgraphSpecs(const std::string &uri, const int max_depth, const std::set<std::string> &relations)
+{
+    nl::json models = nl::json::array();
+    std::set<std::string> visited{uri};
+    std::vector<std::string> level{uri};
+    for (int depth = 0; !level.empty(); depth++)
+    {
+        std::vector<std::string> next_level;
+        for (const auto &current_uri : level)
+        {
+            nl::json model = this->loadSpec(current_uri);
+            if (model.empty())
+                continue;
+            if (max_depth < 0 || depth < max_depth)
+            {
+                for (const auto &target_uri : models::relatedUris(model, relations))
+                {
+                    if (visited.insert(target_uri).second)
+                        next_level.push_back(target_uri);
+                }
+            }
+            models.push_back(std::move(model));
+        }
+        level = std::move(next_level);
+    }
+    return models;
+}
+
+nl::json xdbi::DbInterface::findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                                       const std::size_t limit, const std::vector<std::string> &fields)
+{
+    const SortOrder order(sort);
+    std::vector<std::pair<nl::json, nl::json>> sorted;
+    for (auto &model : this->findSpecs(classname, properties, order.fieldsFor(fields)))
+    {
+        nl::json values = order.valuesOf(model);
+        sorted.emplace_back(std::move(values), models::project(model, fields));
+    }
+    std::sort(sorted.begin(), sorted.end(), [&order](const auto &a, const auto &b) { return order.before(a.first, b.first); });
+    if (limit > 0 && sorted.size() > limit)
+        sorted.resize(limit);
+    nl::json models = nl::json::array();
+    for (auto &entry : sorted)
+        models.push_back(std::move(entry.second));
+    return models;
+}
+
+std::size_t xdbi::DbInterface::count(const std::string &classname, const nl::json &properties)
+{
+    return this->uris(classname, properties).size();
+}
+
+nl::json xdbi::DbInterface::groupCount(const std::string &classname, const std::string &property, const nl::json &properties)
+{
+    // We only need the top-level fields holding the property
+    const std::vector<std::string> fields = {"properties", property.substr(0, property.find('.'))};
+    nl::json groups = nl::json::object();
+    for (const auto &model : this->findSpecs(classname, properties, fields))
+    {
+        const nl::json *value = Query::resolve(model, property);
+        if (!value)
+            continue;
+        const std::string key = value->is_string() ? value->get<std::string>() : value->dump();
+        groups[key] = groups.value(key, 0) + 1;
+    }
+    return groups;
+}
+
+nl::json xdbi::DbInterface::findEdgesFrom(const std::vector<std::string> &uris)
+{
+    nl::json edges = nl::json::object();
+    for (const auto &uri : uris)
+    {
+        const nl::json model = this->loadSpec(uri);
+        if (model.empty())
+            continue;
+        nl::json model_edges = models::edgesOf(model);
+        if (!model_edges.empty())
+            edges[uri] = std::move(model_edges);
+    }
+    return edges;
+}
+
+nl::json xdbi::DbInterface::findEdgesTo(const std::vector<std::string> &uris)
+{
+    nl::json edges = nl::json::object();
+    if (uris.empty())
+        return edges;
+    const nl::json sources = this->findSpecs("", {{"$edge", {{"target", {{"$in", uris}}}}}});
+    for (const auto &model : sources)
+    {
+        for (const auto &[relation, relation_edges] : models::edgesOf(model).items())
+        {
+            for (const auto &edge : relation_edges)
+            {
+                if (std::find(uris.begin(), uris.end(), edge["target"].get<std::string>()) != uris.end())
+                    edges[model["uri"].get<std::string>()][relation].push_back(edge);
+            }
+        }
+    }
+    return edges;
+}
+
+nl::json xdbi::DbInterface::traverse(const std::string &uri, const std::set<std::string> &relations, const std::string &direction,
+                                     const int max_depth, const bool depth_first, const bool uris_only)
+{
+    if (direction != "out" && direction != "in" && direction != "both")
+        throw std::invalid_argument("DbInterface::traverse(): Unknown direction " + direction);
+    const std::vector<std::string> visited_order = models::traverseUris(uri, max_depth, depth_first, [&](const std::string &current) {
+        std::vector<std::string> next;
+        if (direction != "in")
+        {
+            const nl::json edges = this->findEdgesFrom({current});
+            if (edges.contains(current))
+            {
+                for (const auto &[relation, relation_edges] : edges[current].items())
+                {
+                    if (!models::follows(relations, relation))
+                        continue;
+                    for (const auto &edge : relation_edges)
+                        next.push_back(edge["target"].get<std::string>());
+                }
+            }
+        }
+        if (direction != "out")
+        {
+            for (const auto &[source, source_edges] : this->findEdgesTo({current}).items())
+            {
+                for (const auto &[relation, _] : source_edges.items())
+                {
+                    if (models::follows(relations, relation))
+                        next.push_back(source);
+                }
+            }
+        }
+        return next;
+    });
+
+    if (uris_only)
+        return visited_order;
+    nl::json models = nl::json::array();
+    for (const auto &visited_uri : visited_order)
+    {
+        nl::json model = this->loadSpec(visited_uri);
+        if (!model.empty())
+            models.push_back(std::move(model));
+    }
+    return models;
+}
+
+nl::json xdbi::DbInterface::findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset,
+                                     const std::string &cursor, const std::vector<std::string> &fields)
+{
+    // Without native support, the cursor is the last returned uri
+    std::map<std::string, nl::json> ordered;
+    for (auto &model : this->findSpecs(classname, properties, fields))
+    {
+        const std::string uri = model["uri"].get<std::string>();
+        ordered.emplace(uri, std::move(model));
+    }
+    nl::json page = {{"models", nl::json::array()}, {"cursor", ""}};
+    auto it = cursor.empty() ? ordered.begin() : ordered.upper_bound(cursor);
+    for (std::size_t skipped = 0; skipped < offset && it != ordered.end(); skipped++)
+        ++it;
+    for (; it != ordered.end(); ++it)
+    {
+        if (limit > 0 && page["models"].size() >= limit)
+        {
+            page["cursor"] = std::prev(it)->first;
+            break;
+        }
+        page["models"].push_back(std::move(it->second));
+    }
+    return page;
+}
+
+bool xdbi::DbInterface::patch(const std::string &uri, const nl::json &patch)
+{
+    this->checkWriteable();
+    const nl::json model = this->loadSpec(uri);
+    if (model.empty())
+        return false;
+    return this->update(nl::json::array({models::applyPatch(model, patch)}));
+}
+
+nl::json xdbi::DbInterface::dropUnchanged(const nl::json &models)
+{
+    if (!dirty_tracking)
+        return models;
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    nl::json changed = nl::json::array();
+    for (const auto &model : models)
+    {
+        auto it = synced.find(model["uri"].get<std::string>());
+        if (it != synced.end() && it->second == std::hash<nl::json>{}(model))
+            continue;
+        changed.push_back(model);
+    }
+    return changed;
+}
+
+void xdbi::DbInterface::forgetSynced(const nl::json &models)
+{
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    for (const auto &model : models)
+    {
+        if (model.is_object() && model.contains("uri"))
+            synced.erase(model["uri"].get<std::string>());
+    }
+}
+
+void xdbi::DbInterface::forgetSynced()
+{
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    synced.clear();
+}
+
+void xdbi::DbInterface::setDirtyTracking(const bool enabled)
+{
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    dirty_tracking = enabled;
+    if (!enabled)
+        synced.clear();
+}
+
+void xdbi::DbInterface::setIdentityMap(const bool enabled)
+{
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    use_identity_map = enabled;
+    if (!enabled)
+        identities.clear();
+}
+
+nl::json xdbi::DbInterface::exportSpecs(const std::vector<XTypePtr> &xtypes, const int max_depth)
+{
+    // NOTE: Exporting might resolve unknown facts via the registry's load function
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    nl::json models = nl::json::array();
+    // Shared dependencies of the passed xtypes are exported only once (uri -> position in models)
+    std::unordered_map<std::string, std::size_t> exported;
+    for (const auto &xtype : xtypes)
+    {
+        const std::string root_uri = xtype->uri();
+        // Without a depth limit, the complete closure of an already exported xtype is part of the result already
+        if (max_depth < 0 && exported.count(root_uri))
+            continue;
+        std::map< std::string, nl::json> specs = xtype->export_to(max_depth);
+        for (auto &[_,spec] : specs)
+        {
+            const std::string uri = spec["uri"].get<std::string>();
+            auto it = exported.find(uri);
+            if (it == exported.end())
+            {
+                exported.emplace(uri, models.size());
+                models.push_back(std::move(spec));
+            }
+            else if (uri == root_uri)
+            {
+                // With a depth limit, copies exported as dependencies may lack relations, but the root itself is always complete
+                models[it->second] = std::move(spec);
+            }
+        }
+    }
+    return models;
+}
+
+std::future<XTypePtr> xdbi::DbInterface::loadAsync(const std::string &uri, const std::string &classname)
+{
+    return this->async([this, uri, classname]() { return this->load(uri, classname); });
+}
+
+std::future<std::vector<XTypePtr>> xdbi::DbInterface::findAsync(const std::string &classname, const nl::json &properties)
+{
+    return this->async([this, classname, properties]() { return this->find(classname, properties); });
+}
+
+std::future<std::set<std::string>> xdbi::DbInterface::urisAsync(const std::string &classname, const nl::json &properties)
+{
+    return this->async([this, classname, properties]() { return this->uris(classname, properties); });
+}
+
+std::future<bool> xdbi::DbInterface::addAsync(std::vector<XTypePtr> xtypes, const int max_depth)
+{
+    return this->async([this, xtypes, max_depth]() { return this->add(xtypes, max_depth); });
+}
+
+std::future<bool> xdbi::DbInterface::addAsync(nl::json xtypes)
+{
+    return this->async([this, xtypes]() { return this->add(xtypes); });
+}
+
+std::future<bool> xdbi::DbInterface::updateAsync(std::vector<XTypePtr> xtypes, const int max_depth)
+{
+    return this->async([this, xtypes, max_depth]() { return this->update(xtypes, max_depth); });
+}
+
+std::future<bool> xdbi::DbInterface::updateAsync(nl::json xtypes)
+{
+    return this->async([this, xtypes]() { return this->update(xtypes); });
+}
+
+std::future<bool> xdbi::DbInterface::removeAsync(const std::string &uri)
+{
+    return this->async([this, uri]() { return this->remove(uri); });
+}
+
+std::future<bool> xdbi::DbInterface::clearAsync()
+{
+    return this->async([this]() { return this->clear(); });
+}
+
 std::vector<std::string> xdbi::DbInterface::get_available_backends()
 {
     std::vector<std::string> results;
@@ -109,7 +508,16 @@ std::shared_ptr<DbInterface> xdbi::DbInterface::from_config(const XTypeRegistryP
     }
     else if (config["type"] == "Client")
     {
-        out = std::make_shared<Client>(registry, address, graph);
+        auto client = std::make_shared<Client>(registry, address, graph);
+        if (config.contains("pool_size"))
+            client->setConnectionPoolSize(config["pool_size"].get<std::size_t>());
+        if (config.contains("readiness_ttl_ms"))
+            client->setReadinessTTL(config["readiness_ttl_ms"].get<std::time_t>());
+        if (config.contains("health_check_interval_ms"))
+            client->startHealthCheck(config["health_check_interval_ms"].get<std::time_t>());
+        if (config.contains("negative_cache_size") || config.contains("negative_cache_ttl_ms"))
+            client->setNegativeCache(config.value("negative_cache_size", std::size_t(10000)), config.value("negative_cache_ttl_ms", std::time_t(0)));
+        out = client;
         out->read_only = read_only;
     }
     else if (config["type"] == "MultiDbClient")
@@ -130,6 +538,10 @@ std::shared_ptr<DbInterface> xdbi::DbInterface::from_config(const XTypeRegistryP
     }
 
     out->config = config;
+    if (config.contains("identity_map"))
+        out->setIdentityMap(config["identity_map"].get<bool>());
+    if (config.contains("dirty_tracking"))
+        out->setDirtyTracking(config["dirty_tracking"].get<bool>());
     return out;
 }
 
@@ -0,0 +1,80 @@
+#include "Executor.hpp"
+#include <algorithm>
+
+namespace xdbi
+{
+    // The executor the current thread is working for (if any)
+    static thread_local const Executor *current_executor = nullptr;
+
+    Executor::Executor(const std::size_t num_threads)
+    {
+        if (num_threads < 1)
+            throw std::invalid_argument("Executor::Executor(): num_threads has to be at least 1");
+        workers.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; i++)
+        {
+            workers.emplace_back([this]() { this->run(); });
+        }
+    }
+
+    Executor::~Executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+        for (auto &worker : workers)
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+
+    Executor &Executor::shared()
+    {
+        static Executor executor(std::max(2u, std::thread::hardware_concurrency()));
+        return executor;
+    }
+
+    bool Executor::isWorkerThread() const
+    {
+        return current_executor == this;
+    }
+
+    std::size_t Executor::size() const
+    {
+        return workers.size();
+    }
+
+    void Executor::enqueue(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            if (stopping)
+                throw std::runtime_error("Executor::enqueue(): executor is shutting down");
+            jobs.push_back(std::move(job));
+        }
+        jobAvailable.notify_one();
+    }
+
+    void Executor::run()
+    {
+        current_executor = this;
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(jobsMutex);
+                jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                // NOTE: We finish all pending jobs before we stop
+                if (jobs.empty())
+                    return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            // Exceptions are stored in the future by std::packaged_task
+            job();
+        }
+    }
+}
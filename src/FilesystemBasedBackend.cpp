@@ -113,6 +113,24 @@ namespace xdbi
         return files;
     }
 
+    std::size_t FilesystemBasedBackend::getGeneration(const std::string &graph)
+    {
+        // NOTE: We only look at the file names (not at their content), so this is as cheap as a directory listing
+        return getGeneration(this->getFiles(graph));
+    }
+
+    std::size_t FilesystemBasedBackend::getGeneration(const std::map<std::string, fs::path> &files)
+    {
+        std::size_t generation = 0;
+        for (const auto &[fname, fpath] : files)
+        {
+            const std::size_t h = std::hash<std::string>{}(fpath.parent_path().filename().string() + '/' + fname);
+            // NOTE: The hashes are combined in an order independent way, so the stamp only depends on the set of files
+            generation += h * 0x9e3779b97f4a7c15ULL + (h >> 7);
+        }
+        return generation;
+    }
+
     bool FilesystemBasedBackend::removeFiles(const std::string &graph, const std::set<std::string> &uris)
     {
         std::map<std::string, fs::path> files = this->getFiles(graph);
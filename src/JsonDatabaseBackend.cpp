@@ -1,6 +1,9 @@
 #include "JsonDatabaseBackend.hpp"
 #include "FilesystemBasedLock.hpp"
+#include "Query.hpp"
+#include "Models.hpp"
 #include <fstream>
+#include <algorithm>
 #include <deque>
 #include <set>
 #include <xtypes_generator/utils.hpp>
@@ -34,29 +37,67 @@ namespace xdbi
         return xtypes;
     }
 
-    nl::json JsonDatabaseBackend::getXtypes(const std::string &graph, const std::string &classname)
+    nl::json JsonDatabaseBackend::getXtypes(const std::string &graph, const std::string &classname, const std::set<std::string> &keys)
     {
         nl::json xtypes;
-        const std::map<std::string, fs::path> files = this->getFiles(graph, classname);
-        for (const auto &[fname, fpath] : files)
+        this->_forEach(graph, classname, [&xtypes](nl::json &info) {
+            const std::string uri = info["uri"].get<std::string>();
+            xtypes[uri] = std::move(info);
+            return true;
+        }, keys);
+        return xtypes;
+    }
+
+    bool JsonDatabaseBackend::forEach(const std::string &classname, const std::function<bool(nl::json &)> &visitor)
+    {
+        return this->forEach(m_graph, classname, visitor);
+    }
+    bool JsonDatabaseBackend::forEach(const std::string &graph, const std::string &classname, const std::function<bool(nl::json &)> &visitor)
+    {
+        GUARD_DATABASE(graph);
+        return this->_forEach(graph, classname, visitor);
+    }
+    bool JsonDatabaseBackend::_forEach(const std::string &graph, const std::string &classname, const std::function<bool(nl::json &)> &visitor,
+                                       const std::set<std::string> &keys, const std::string &after)
+    {
+        return this->_forEach(this->getFiles(graph, classname), classname, visitor, keys, after);
+    }
+    bool JsonDatabaseBackend::_forEach(const std::map<std::string, fs::path> &files, const std::string &classname, const std::function<bool(nl::json &)> &visitor,
+                                       const std::set<std::string> &keys, const std::string &after)
+    {
+        for (auto it = after.empty() ? files.begin() : files.upper_bound(after); it != files.end(); ++it)
         {
-            const nl::json info = this->loadAndCheck(fname, fpath, classname);
+            nl::json info = this->loadAndCheck(it->first, it->second, classname, keys);
             if (info.empty())
                 continue;
-            const std::string uri = info["uri"].get<std::string>();
-            xtypes[uri] = info;
+            if (!visitor(info))
+                return false;
         }
-        return xtypes;
+        return true;
     }
 
-    nl::json JsonDatabaseBackend::loadAndCheck(const std::string &fname, const fs::path &fpath, const std::string &classname)
+    nl::json JsonDatabaseBackend::loadAndCheck(const std::string &fname, const fs::path &fpath, const std::string &classname, const std::set<std::string> &keys)
     {
         LOGI("Loading from file " << fpath << "...");
         std::ifstream ifs{fpath.string()};
         nl::json info;
         try
         {
-            info = nl::json::parse(ifs);
+            if (keys.empty())
+            {
+                info = nl::json::parse(ifs);
+            }
+            else
+            {
+                // Skipped top-level keys are still tokenized but their values are never built
+                const nl::json::parser_callback_t keep = [&keys](int depth, nl::json::parse_event_t event, nl::json &parsed) {
+                    if (depth != 1 || event != nl::json::parse_event_t::key)
+                        return true;
+                    const std::string &key = parsed.get_ref<const std::string &>();
+                    return key == "uri" || key == "uuid" || key == "classname" || keys.count(key) > 0;
+                };
+                info = nl::json::parse(ifs, keep);
+            }
         }
         catch (const nl::json::parse_error &e)
         {
@@ -339,47 +380,272 @@ namespace xdbi
         return success;
     }
 
+    bool JsonDatabaseBackend::patch(const std::string &uri, const nl::json &patch)
+    {
+        GUARD_DATABASE(m_graph);
+        return this->_patch(uri, patch);
+    }
+    bool JsonDatabaseBackend::_patch(const std::string &uri, const nl::json &patch)
+    {
+        LOGI("Patching " << uri << " in m_graph " << m_graph << " ...");
+        const nl::json db_model = this->_load(uri);
+        if (db_model.empty())
+        {
+            LOGE("patch(): Could not find " << uri);
+            return false;
+        }
+        // The patched model is complete, so the update semantics (incl. delete policies of removed edges) apply as is
+        return this->_update(nl::json::array({models::applyPatch(db_model, patch)}));
+    }
+
     nl::json JsonDatabaseBackend::find(const std::string &classname, const nl::json &properties)
     {
         GUARD_DATABASE(m_graph);
         nl::json results = this->_find(classname, properties);
         return results;
     }
-    nl::json JsonDatabaseBackend::_find(const std::string &classname, const nl::json &properties)
+    nl::json JsonDatabaseBackend::find(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields)
+    {
+        GUARD_DATABASE(m_graph);
+        nl::json results = this->_find(classname, properties, fields);
+        return results;
+    }
+    nl::json JsonDatabaseBackend::_find(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields)
     {
         LOGI("Finding " << classname << " with properties " << properties << " ...");
         nl::json results(nl::json::value_t::array);
-        if (properties.contains("uri"))
+        this->_findEach(classname, properties, fields, [&results](const nl::json &model) {
+            results.push_back(model);
+        });
+
+        return results;
+    }
+
+    nl::json JsonDatabaseBackend::findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                                             const std::size_t limit, const std::vector<std::string> &fields)
+    {
+        GUARD_DATABASE(m_graph);
+        nl::json results = this->_findSorted(classname, properties, sort, limit, fields);
+        return results;
+    }
+    nl::json JsonDatabaseBackend::_findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                                              const std::size_t limit, const std::vector<std::string> &fields)
+    {
+        LOGI("Finding the first " << limit << " " << classname << " with properties " << properties << " sorted by " << nl::json(sort) << " ...");
+        const SortOrder order(sort);
+        // The heap has the model which comes last on top, so it is the one to drop when there are more than limit
+        using Entry = std::pair<nl::json, nl::json>;
+        auto comes_before = [&order](const Entry &a, const Entry &b) { return order.before(a.first, b.first); };
+        std::vector<Entry> top;
+        this->_findEach(classname, properties, order.fieldsFor(fields), [&](const nl::json &model) {
+            top.emplace_back(order.valuesOf(model), models::project(model, fields));
+            std::push_heap(top.begin(), top.end(), comes_before);
+            if (limit > 0 && top.size() > limit)
+            {
+                std::pop_heap(top.begin(), top.end(), comes_before);
+                top.pop_back();
+            }
+        });
+        std::sort_heap(top.begin(), top.end(), comes_before);
+        nl::json results(nl::json::value_t::array);
+        for (auto &entry : top)
+            results.push_back(std::move(entry.second));
+        return results;
+    }
+
+    std::size_t JsonDatabaseBackend::count(const std::string &classname, const nl::json &properties)
+    {
+        GUARD_DATABASE(m_graph);
+        return this->_count(classname, properties);
+    }
+    std::size_t JsonDatabaseBackend::_count(const std::string &classname, const nl::json &properties)
+    {
+        LOGI("Counting " << classname << " with properties " << properties << " ...");
+        std::size_t n = 0;
+        // Without a query, the adjacency index already knows the valid models, so only new or modified files are parsed
+        if (properties.empty())
         {
-            const std::string uri = properties["uri"].get<std::string>();
-            const nl::json model = this->_load(uri, classname);
-            if(not model.is_null())
-                results.push_back(model);
-            return results;
+            std::lock_guard<std::mutex> lock(m_adjacency_mutex);
+            for (const auto &[fname, node] : this->adjacency(m_graph).nodes)
+            {
+                if (classname.empty() || node.classname == classname)
+                    n++;
+            }
+            return n;
         }
-        const nl::json all_xtypes = this->getXtypes(m_graph, classname);
-        for (const auto &[uri, model] : all_xtypes.items())
+        const Query query(properties);
+        if (query.uris())
         {
-            bool matches = true;
-            const nl::json& model_properties = model.contains("properties") ? model["properties"] : model;
-            for (const auto &[k2, v2] : properties.items())
+            for (const auto &uri : *query.uris())
             {
-                if (!model_properties.contains(k2))
-                {
-                    matches = false;
-                    break;
-                }
-                if (v2 != model_properties[k2])
-                {
-                    matches = false;
-                    break;
-                }
+                const nl::json model = uri.empty() ? nl::json() : this->_load(uri, classname);
+                if (!model.is_null() && query.matches(model))
+                    n++;
             }
-            if (matches)
-                results.push_back(model);
+            return n;
         }
+        std::set<std::string> keys = query.keys();
+        if (!keys.empty())
+            keys.insert("properties");
+        const std::map<std::string, fs::path> files = query.constrainsRelations() ? this->_findSources(classname, query) : this->getFiles(m_graph, classname);
+        this->_forEach(files, classname, [&](nl::json &model) {
+            if (query.matches(model))
+                n++;
+            return true;
+        }, keys);
+        return n;
+    }
 
-        return results;
+    nl::json JsonDatabaseBackend::groupCount(const std::string &classname, const std::string &property, const nl::json &properties)
+    {
+        GUARD_DATABASE(m_graph);
+        nl::json groups = this->_groupCount(classname, property, properties);
+        return groups;
+    }
+    nl::json JsonDatabaseBackend::_groupCount(const std::string &classname, const std::string &property, const nl::json &properties)
+    {
+        LOGI("Counting " << classname << " with properties " << properties << " grouped by " << property << " ...");
+        nl::json groups = nl::json::object();
+        const Query query(properties);
+        // Only the grouping property and the keys needed by the query have to be parsed
+        std::set<std::string> keys;
+        if (!query.keys().empty() || properties.empty())
+        {
+            keys = query.keys();
+            keys.insert({"properties", property, property.substr(0, property.find('.'))});
+        }
+        auto group = [&](const nl::json &model) {
+            if (!query.matches(model))
+                return;
+            const nl::json *value = Query::resolve(model, property);
+            if (!value)
+                return;
+            const std::string key = value->is_string() ? value->get<std::string>() : value->dump();
+            groups[key] = groups.value(key, 0) + 1;
+        };
+        if (query.uris())
+        {
+            for (const auto &uri : *query.uris())
+            {
+                const nl::json model = uri.empty() ? nl::json() : this->_load(uri, classname);
+                if (!model.is_null())
+                    group(model);
+            }
+            return groups;
+        }
+        const std::map<std::string, fs::path> files = query.constrainsRelations() ? this->_findSources(classname, query) : this->getFiles(m_graph, classname);
+        this->_forEach(files, classname, [&](nl::json &model) {
+            group(model);
+            return true;
+        }, keys);
+        return groups;
+    }
+
+    void JsonDatabaseBackend::findEach(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields,
+                                       const std::function<void(const nl::json &)> &visitor)
+    {
+        GUARD_DATABASE(m_graph);
+        this->_findEach(classname, properties, fields, visitor);
+    }
+    void JsonDatabaseBackend::_findEach(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields,
+                                        const std::function<void(const nl::json &)> &visitor)
+    {
+        LOGI("Visiting " << classname << " with properties " << properties << " ...");
+        const Query query(properties);
+        if (query.uris())
+        {
+            // The uris are known, so we look the models up directly instead of scanning the class
+            for (const auto &uri : *query.uris())
+            {
+                if (uri.empty())
+                    continue;
+                const nl::json model = this->_load(uri, classname);
+                if (!model.is_null() && query.matches(model))
+                    visitor(models::project(model, fields));
+            }
+            return;
+        }
+        // Edge conditions are looked up in the adjacency index, so we only have to parse the models with matching edges
+        const std::map<std::string, fs::path> files = query.constrainsRelations() ? this->_findSources(classname, query) : this->getFiles(m_graph, classname);
+        this->_forEach(files, classname, [&](nl::json &model) {
+            if (query.matches(model))
+                visitor(models::project(model, fields));
+            return true;
+        }, projectionKeys(query, fields));
+    }
+
+    nl::json JsonDatabaseBackend::findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset,
+                                           const std::string &cursor, const std::vector<std::string> &fields)
+    {
+        GUARD_DATABASE(m_graph);
+        nl::json page = this->_findPage(classname, properties, limit, offset, cursor, fields);
+        return page;
+    }
+    nl::json JsonDatabaseBackend::_findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset,
+                                            const std::string &cursor, const std::vector<std::string> &fields)
+    {
+        LOGI("Finding page of " << limit << " " << classname << " with properties " << properties << " after '" << cursor << "' ...");
+        nl::json page = {{"models", nl::json::array()}, {"cursor", ""}};
+        const Query query(properties);
+        if (query.uris() && query.uris()->size() <= 1)
+        {
+            // There is at most one match, so it is on the first page
+            if (offset == 0 && cursor.empty())
+                page["models"] = this->_find(classname, properties, fields);
+            return page;
+        }
+        // The file names (uuids) are the stable sort key and the last returned one is the cursor.
+        // So we only have to parse the files until the page is full.
+        std::size_t skipped = 0;
+        std::string last;
+        const std::map<std::string, fs::path> files = query.constrainsRelations() ? this->_findSources(classname, query) : this->getFiles(m_graph, classname);
+        this->_forEach(files, classname, [&](nl::json &model) {
+            if (limit > 0 && page["models"].size() >= limit)
+            {
+                page["cursor"] = last;
+                return false;
+            }
+            // NOTE: loadAndCheck() ensured that the uuid is the file name
+            last = model["uuid"].get<std::string>();
+            if (!query.matches(model))
+                return true;
+            if (skipped < offset)
+            {
+                skipped++;
+                return true;
+            }
+            page["models"].push_back(models::project(model, fields));
+            return true;
+        }, projectionKeys(query, fields), cursor);
+        return page;
+    }
+
+    std::set<std::string> JsonDatabaseBackend::projectionKeys(const Query &query, const std::vector<std::string> &fields)
+    {
+        // When projecting, we only need to parse the requested fields and the ones needed for matching
+        std::set<std::string> keys;
+        if (fields.empty() || query.complete())
+            return keys;
+        keys.insert(fields.begin(), fields.end());
+        // Paths of the query are resolved in the properties first
+        if (!query.keys().empty())
+            keys.insert("properties");
+        keys.insert(query.keys().begin(), query.keys().end());
+        return keys;
+    }
+
+    std::map<std::string, fs::path> JsonDatabaseBackend::_findSources(const std::string &classname, const Query &query)
+    {
+        std::lock_guard<std::mutex> lock(m_adjacency_mutex);
+        std::map<std::string, fs::path> files;
+        for (const auto &[fname, node] : this->adjacency(m_graph).nodes)
+        {
+            if (!classname.empty() && node.classname != classname)
+                continue;
+            if (query.matchesRelations(node.relations))
+                files[fname] = node.path;
+        }
+        return files;
     }
 
     bool JsonDatabaseBackend::remove(const std::string &uri)
@@ -390,6 +656,9 @@ namespace xdbi
     bool JsonDatabaseBackend::_remove(const std::string &uri)
     {
         LOGI("Removing " << uri << " from m_graph " << m_graph);
+        // NOTE: Like _removeEdgesTo(), the cascade does not trust the adjacency index, because a missed source would not be removed.
+        // All models are scanned once up front instead.
+        const nl::json incoming = this->_scanEdgesTo();
         std::set<std::string> to_be_removed;
         std::deque<std::string> to_be_visited = {uri};
         while (to_be_visited.size() > 0)
@@ -441,7 +710,7 @@ namespace xdbi
                 }
             }
             // Follow backward edges and remove any targets which are referenced by a matching delete_policy
-            const nl::json backward_edges = this->_findEdgesTo({other_uri});
+            const nl::json backward_edges = incoming.value(other_uri, nl::json::object());
             for (const auto &[backward_uri, _] : backward_edges.items())
             {
                 for (const auto &[attr, edges] : backward_edges[backward_uri].items())
@@ -533,6 +802,8 @@ namespace xdbi
         const std::string classname = xtype["classname"].get<std::string>();
         const std::string uri = xtype["uri"].get<std::string>();
         const fs::path path = createFilePath(m_graph, classname, uri);
+        // The file might be rewritten within the resolution of its modification time, so we do not rely on it
+        this->forgetAdjacency(m_graph, uri);
 
         // - Open file at 'path' and write to it
         if (std::ofstream ofs{path.string()})
@@ -546,6 +817,98 @@ namespace xdbi
         return false;
     }
 
+    nl::json JsonDatabaseBackend::loadSubgraph(const std::string &uri, const int max_depth, const std::set<std::string> &relations)
+    {
+        GUARD_DATABASE(m_graph);
+        nl::json result = this->_loadSubgraph(uri, max_depth, relations);
+        return result;
+    }
+    nl::json JsonDatabaseBackend::_loadSubgraph(const std::string &uri, const int max_depth, const std::set<std::string> &relations)
+    {
+        LOGI("Loading subgraph of " << uri << " up to depth " << max_depth);
+        nl::json models = nl::json::array();
+        // We list the files only once instead of once per loaded model
+        const std::map<std::string, fs::path> files = this->getFiles(m_graph);
+        std::set<std::string> visited{uri};
+        std::deque<std::pair<std::string, int>> to_be_visited{{uri, 0}};
+        while (!to_be_visited.empty())
+        {
+            const auto [current_uri, depth] = to_be_visited.front();
+            to_be_visited.pop_front();
+            const std::string filename = getFileName(current_uri);
+            if (files.find(filename) == files.end())
+                continue;
+            nl::json model = this->loadAndCheck(filename, files.at(filename), "");
+            if (model.empty())
+                continue;
+            if (max_depth < 0 || depth < max_depth)
+            {
+                for (const auto &target_uri : models::relatedUris(model, relations))
+                {
+                    if (visited.insert(target_uri).second)
+                        to_be_visited.emplace_back(target_uri, depth + 1);
+                }
+            }
+            models.push_back(std::move(model));
+        }
+        return models;
+    }
+
+    nl::json JsonDatabaseBackend::traverse(const std::string &uri, const std::set<std::string> &relations, const std::string &direction,
+                                           const int max_depth, const bool depth_first, const bool uris_only)
+    {
+        GUARD_DATABASE(m_graph);
+        nl::json result = this->_traverse(uri, relations, direction, max_depth, depth_first, uris_only);
+        return result;
+    }
+    nl::json JsonDatabaseBackend::_traverse(const std::string &uri, const std::set<std::string> &relations, const std::string &direction,
+                                            const int max_depth, const bool depth_first, const bool uris_only)
+    {
+        LOGI("Traversing " << direction << " from " << uri << " up to depth " << max_depth << (depth_first ? " depth-first" : " breadth-first"));
+        if (direction != "out" && direction != "in" && direction != "both")
+            throw std::invalid_argument("JsonDatabaseBackend::traverse(): Unknown direction " + direction);
+        const bool out = direction != "in";
+        const bool in = direction != "out";
+
+        std::vector<std::string> visited_order;
+        std::map<std::string, fs::path> stored;
+        {
+            std::lock_guard<std::mutex> lock(m_adjacency_mutex);
+            const Adjacency &adjacency = this->adjacency(m_graph);
+            // Uris which are referenced but not stored here cannot be followed
+            auto find = [this, &adjacency](const std::string &current) {
+                auto node = adjacency.nodes.find(this->getFileName(current));
+                return node != adjacency.nodes.end() && node->second.uri == current ? node : adjacency.nodes.end();
+            };
+            visited_order = models::traverseUris(uri, max_depth, depth_first, [&](const std::string &current) {
+                auto node = find(current);
+                if (node == adjacency.nodes.end())
+                    return std::vector<std::string>();
+                return adjacency.neighbours(current, node->first, relations, out, in);
+            });
+            for (const auto &visited_uri : visited_order)
+            {
+                auto node = find(visited_uri);
+                if (node != adjacency.nodes.end())
+                    stored[visited_uri] = node->second.path;
+            }
+        }
+
+        if (uris_only)
+            return visited_order;
+        nl::json models = nl::json::array();
+        for (const auto &visited_uri : visited_order)
+        {
+            auto it = stored.find(visited_uri);
+            if (it == stored.end())
+                continue;
+            nl::json model = this->loadAndCheck(getFileName(visited_uri), it->second, "");
+            if (!model.empty())
+                models.push_back(std::move(model));
+        }
+        return models;
+    }
+
     nl::json JsonDatabaseBackend::findEdgesFrom(const std::vector<std::string> &uris)
     {
         GUARD_DATABASE(m_graph);
@@ -554,29 +917,15 @@ namespace xdbi
     }
     nl::json JsonDatabaseBackend::_findEdgesFrom(const std::vector<std::string> &uris)
     {
-        nl::json edges;
+        nl::json edges = nl::json::object();
         for (const auto &uri : uris)
         {
             const nl::json db_model = this->_load(uri);
             if (db_model.empty())
                 continue;
-            const nl::json& relations = db_model.contains("relations") ? db_model["relations"] : db_model;
-            for (const auto &[k, v] : relations.items())
-            {
-                if (!v.is_array())
-                    continue;
-                for (auto potential_edge : v)
-                {
-                    if (!potential_edge.is_structured())
-                        continue;
-                    if (!potential_edge.contains("edge_properties"))
-                        continue;
-                    if (!potential_edge.contains("target"))
-                        continue;
-                    potential_edge["source"] = uri;
-                    edges[uri][k].push_back(potential_edge);
-                }
-            }
+            const nl::json model_edges = models::edgesOf(db_model);
+            if (!model_edges.empty())
+                edges[uri] = model_edges;
         }
         return edges;
     }
@@ -589,33 +938,47 @@ namespace xdbi
     }
     nl::json JsonDatabaseBackend::_findEdgesTo(const std::vector<std::string> &uris)
     {
-        nl::json edges;
-        const nl::json all_xtypes = this->getXtypes(m_graph);
-        for (const auto &[db_uri, db_model] : all_xtypes.items())
+        nl::json edges = nl::json::object();
+        std::lock_guard<std::mutex> lock(m_adjacency_mutex);
+        Adjacency &adjacency = this->adjacency(m_graph);
+        // Only the sources known to refer to one of the uris have to be looked at
+        std::set<std::string> sources;
+        for (const auto &uri : uris)
         {
-            const nl::json& relations = db_model.contains("relations") ? db_model["relations"] : db_model;
-            for (const auto &[k, v] : relations.items())
+            auto it = adjacency.incoming.find(uri);
+            if (it != adjacency.incoming.end())
+                sources.insert(it->second.begin(), it->second.end());
+        }
+        for (const auto &fname : sources)
+        {
+            const Adjacency::Node &node = adjacency.nodes.at(fname);
+            for (const auto &[k, v] : node.relations.items())
             {
-                if (!v.is_array())
-                    continue;
-                for (auto potential_edge : v)
+                for (const auto &edge : v)
                 {
-                    if (!potential_edge.is_structured())
-                        continue;
-                    if (!potential_edge.contains("edge_properties"))
+                    if (std::find(uris.begin(), uris.end(), edge["target"].get<std::string>()) == uris.end())
                         continue;
-                    if (!potential_edge.contains("target"))
-                        continue;
-                    if (std::find(uris.begin(), uris.end(), potential_edge["target"].get<std::string>()) == uris.end())
-                        continue;
-                    potential_edge["source"] = db_uri;
-                    edges[db_uri][k].push_back(potential_edge);
+                    edges[node.uri][k].push_back(edge);
                 }
             }
         }
         return edges;
     }
 
+    nl::json JsonDatabaseBackend::_scanEdgesTo()
+    {
+        nl::json edges = nl::json::object();
+        this->_forEach(m_graph, "", [&edges](nl::json &model) {
+            for (const auto &[k, v] : models::edgesOf(model).items())
+            {
+                for (const auto &edge : v)
+                    edges[edge["target"].get<std::string>()][edge["source"].get<std::string>()][k].push_back(edge);
+            }
+            return true;
+        });
+        return edges;
+    }
+
     void JsonDatabaseBackend::removeEdgesTo(const std::vector<std::string> &uris)
     {
         GUARD_DATABASE(m_graph);
@@ -624,9 +987,10 @@ namespace xdbi
 
     void JsonDatabaseBackend::_removeEdgesTo(const std::vector<std::string> &uris)
     {
-        nl::json all_xtypes = this->getXtypes(m_graph);
-        for (auto &[db_uri, db_model] : all_xtypes.items())
-        {
+        // NOTE: We scan all models instead of asking the adjacency index, because it cannot notice every change of other processes
+        // (e.g. a rewrite with the same mtime and size) and a missed source would keep a dangling edge forever
+        this->_forEach(m_graph, "", [&](nl::json &db_model) {
+            bool modified = false;
             // Check if we already have the "relations" key
             auto relations_items = db_model.contains("relations") ? db_model["relations"].items() : db_model.items();
             // Cycle through all references and remove given uri(s) from it
@@ -646,7 +1010,7 @@ namespace xdbi
                             continue;
                         if (!potential_edge.contains("edge_properties"))
                             continue;
-                        if (!potential_edge.contains("target"))
+                        if (!potential_edge.contains("target") || !potential_edge["target"].is_string())
                             continue;
                         // if target uri is not in uris
                         if (std::find(uris.begin(), uris.end(), potential_edge["target"].get<std::string>()) == uris.end())
@@ -658,11 +1022,134 @@ namespace xdbi
                     {
                         // NOTE: When we delete an index the entries AFTER the current index will move forward, so we start again
                         v.erase(index);
+                        modified = true;
                     }
                 } while (found_one);
             }
-            this->_store(db_model);
+            // Models which do not refer to any of the uris stay untouched
+            if (modified)
+                this->_store(db_model);
+            return true;
+        });
+    }
+
+    void JsonDatabaseBackend::Adjacency::insert(const std::string &fname, Node node)
+    {
+        for (const auto &[k, v] : node.relations.items())
+        {
+            for (const auto &edge : v)
+                incoming[edge["target"].get<std::string>()].insert(fname);
+        }
+        nodes[fname] = std::move(node);
+    }
+
+    void JsonDatabaseBackend::Adjacency::erase(const std::string &fname)
+    {
+        auto it = nodes.find(fname);
+        if (it == nodes.end())
+            return;
+        for (const auto &[k, v] : it->second.relations.items())
+        {
+            for (const auto &edge : v)
+            {
+                auto in = incoming.find(edge["target"].get<std::string>());
+                if (in == incoming.end())
+                    continue;
+                in->second.erase(fname);
+                if (in->second.empty())
+                    incoming.erase(in);
+            }
+        }
+        nodes.erase(it);
+    }
+
+    std::vector<std::string> JsonDatabaseBackend::Adjacency::neighbours(const std::string &uri, const std::string &fname, const std::set<std::string> &relations,
+                                                                        const bool out, const bool in) const
+    {
+        std::vector<std::string> result;
+        if (out)
+        {
+            for (const auto &[k, v] : nodes.at(fname).relations.items())
+            {
+                if (!models::follows(relations, k))
+                    continue;
+                for (const auto &edge : v)
+                    result.push_back(edge["target"].get<std::string>());
+            }
+        }
+        if (in)
+        {
+            auto sources = incoming.find(uri);
+            if (sources == incoming.end())
+                return result;
+            for (const auto &source : sources->second)
+            {
+                const Node &node = nodes.at(source);
+                for (const auto &[k, v] : node.relations.items())
+                {
+                    if (!models::follows(relations, k))
+                        continue;
+                    if (std::any_of(v.begin(), v.end(), [&uri](const nl::json &edge) { return edge["target"] == uri; }))
+                        result.push_back(node.uri);
+                }
+            }
+        }
+        return result;
+    }
+
+    JsonDatabaseBackend::Adjacency &JsonDatabaseBackend::adjacency(const std::string &graph)
+    {
+        Adjacency &adjacency = m_adjacency[graph];
+        const std::map<std::string, fs::path> files = this->getFiles(graph);
+        // Forget the models which have been removed ...
+        std::vector<std::string> removed;
+        for (const auto &[fname, _] : adjacency.nodes)
+        {
+            if (files.count(fname) == 0)
+                removed.push_back(fname);
+        }
+        for (const auto &fname : removed)
+            adjacency.erase(fname);
+        // ... and parse the ones which have been added or modified since the last use
+        for (const auto &[fname, fpath] : files)
+        {
+            const auto mtime = fs::last_write_time(fpath);
+            const std::uintmax_t size = fs::file_size(fpath);
+            auto it = adjacency.nodes.find(fname);
+            if (it != adjacency.nodes.end() && it->second.path == fpath && it->second.mtime == mtime && it->second.size == size)
+                continue;
+            adjacency.erase(fname);
+            const nl::json model = this->loadAndCheck(fname, fpath, "");
+            if (model.empty())
+                continue;
+            adjacency.insert(fname, {fpath, mtime, size, model["uri"].get<std::string>(), model["classname"].get<std::string>(), models::edgesOf(model)});
+        }
+        return adjacency;
+    }
+
+    void JsonDatabaseBackend::forgetAdjacency(const std::string &graph, const std::string &uri)
+    {
+        std::lock_guard<std::mutex> lock(m_adjacency_mutex);
+        auto it = m_adjacency.find(graph);
+        if (it != m_adjacency.end())
+            it->second.erase(getFileName(uri));
+    }
+
+    nl::json JsonDatabaseBackend::getMembership(const std::size_t known_generation)
+    {
+        GUARD_DATABASE(m_graph);
+        nl::json membership;
+        // The class directories are listed only once for both the generation and the uuids
+        const std::map<std::string, fs::path> files = this->getFiles(m_graph);
+        membership["generation"] = getGeneration(files);
+        if (known_generation != 0 && membership["generation"].get<std::size_t>() == known_generation)
+            return membership;
+        membership["uuids"] = nl::json::array();
+        for (const auto &[fname, _] : files)
+        {
+            membership["uuids"].push_back(fname);
         }
+        return membership;
     }
 
     void JsonDatabaseBackend::setWorkingGraph(const std::string &graph)
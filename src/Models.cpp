@@ -0,0 +1,148 @@
+#include "Models.hpp"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <stdexcept>
+
+namespace xdbi::models
+{
+    nl::json edgesOf(const nl::json &model)
+    {
+        nl::json edges = nl::json::object();
+        const std::string uri = model.value("uri", "");
+        const nl::json& relations = model.contains("relations") ? model["relations"] : model;
+        for (const auto &[k, v] : relations.items())
+        {
+            if (!v.is_array())
+                continue;
+            for (auto potential_edge : v)
+            {
+                if (!potential_edge.is_structured())
+                    continue;
+                if (!potential_edge.contains("edge_properties"))
+                    continue;
+                if (!potential_edge.contains("target"))
+                    continue;
+                // Edges are looked up by their target uri (e.g. in the adjacency index), so malformed targets are skipped
+                if (!potential_edge["target"].is_string())
+                    continue;
+                potential_edge["source"] = uri;
+                edges[k].push_back(potential_edge);
+            }
+        }
+        return edges;
+    }
+
+    std::vector<std::string> traverseUris(const std::string &uri, const int max_depth, const bool depth_first,
+                                          const std::function<std::vector<std::string>(const std::string &)> &neighbours)
+    {
+        std::vector<std::string> visited_order;
+        std::set<std::string> visited;
+        // Depth-first only: The smallest depth at which a uri has been expanded.
+        // With a max_depth, a uri first reached on a long path has to be expanded again when it is reached on a shorter one,
+        // otherwise the uris behind it which are within max_depth on the shorter path would be missed.
+        std::map<std::string, int> expanded_at;
+        // Breadth-first takes from the front, depth-first from the back of the same container
+        std::deque<std::pair<std::string, int>> to_be_visited{{uri, 0}};
+        if (!depth_first)
+            visited.insert(uri);
+        while (!to_be_visited.empty())
+        {
+            const auto [current, depth] = depth_first ? to_be_visited.back() : to_be_visited.front();
+            if (depth_first)
+            {
+                to_be_visited.pop_back();
+                auto it = expanded_at.find(current);
+                if (it != expanded_at.end() && (max_depth < 0 || it->second <= depth))
+                    continue;
+                expanded_at[current] = depth;
+                // Every uri is reported only once (when it is reached first)
+                if (visited.insert(current).second)
+                    visited_order.push_back(current);
+            }
+            else
+            {
+                to_be_visited.pop_front();
+                visited_order.push_back(current);
+            }
+            if (max_depth >= 0 && depth >= max_depth)
+                continue;
+            std::vector<std::string> next = neighbours(current);
+            // Depth-first visits the last pushed uri first, so we push in reverse to keep the order of the edges
+            if (depth_first)
+                std::reverse(next.begin(), next.end());
+            for (const auto &next_uri : next)
+            {
+                if (depth_first)
+                {
+                    auto it = expanded_at.find(next_uri);
+                    if (it == expanded_at.end() || (max_depth >= 0 && it->second > depth + 1))
+                        to_be_visited.emplace_back(next_uri, depth + 1);
+                }
+                else if (visited.insert(next_uri).second)
+                {
+                    to_be_visited.emplace_back(next_uri, depth + 1);
+                }
+            }
+        }
+        return visited_order;
+    }
+
+    bool follows(const std::set<std::string> &relations, const std::string &relation)
+    {
+        return relations.empty() || relations.count(relation) > 0;
+    }
+
+    std::vector<std::string> relatedUris(const nl::json &model, const std::set<std::string> &relations)
+    {
+        std::vector<std::string> targets;
+        for (const auto &[k, v] : edgesOf(model).items())
+        {
+            if (!follows(relations, k))
+                continue;
+            for (const auto &edge : v)
+                targets.push_back(edge["target"].get<std::string>());
+        }
+        return targets;
+    }
+
+    nl::json project(const nl::json &model, const std::vector<std::string> &fields)
+    {
+        if (fields.empty())
+            return model;
+        nl::json projected = {{"uri", model["uri"]}};
+        for (const auto &field : fields)
+        {
+            if (model.contains(field))
+                projected[field] = model[field];
+        }
+        return projected;
+    }
+
+    nl::json applyPatch(const nl::json &model, const nl::json &patch)
+    {
+        // The update semantics would mix up the properties and relations of models stored in the old flat format
+        if (!model.contains("properties"))
+            throw std::invalid_argument("patch(): " + model.value("uri", std::string()) + " is stored in the flat format and cannot be patched (update it instead)");
+        nl::json patched;
+        if (patch.is_array())
+        {
+            patched = model.patch(patch);
+        }
+        else if (patch.is_object())
+        {
+            patched = model;
+            patched.merge_patch(patch);
+        }
+        else
+        {
+            throw std::invalid_argument("patch(): Expected a JSON Patch (array) or a JSON Merge Patch (object)");
+        }
+        for (const std::string key : {"uri", "uuid", "classname"})
+        {
+            if (patched.value(key, nl::json()) != model.value(key, nl::json()))
+                throw std::invalid_argument("patch(): The " + key + " of a model cannot be patched");
+        }
+        return patched;
+    }
+}
@@ -1,15 +1,19 @@
 #include "MultiDbClient.hpp"
 
 #include <iostream>
+#include <algorithm>
+#include <map>
+#include <numeric>
 
 #include "Serverless.hpp"
 #include "Client.hpp"
+#include "Logger.hpp"
 
 using namespace xtypes;
 using namespace xdbi;
 
 xdbi::MultiDbClient::MultiDbClient(const XTypeRegistryPtr registry, const nl::json &config)
-    : DbInterface(registry), multi_config(config)
+    : DbInterface(registry), multi_config(config), statistics(std::make_shared<StatisticsTable>())
 {
     if (!multi_config.contains("import_servers") || !multi_config["import_servers"].is_array())
         throw std::runtime_error("Invalid config; no valid import_servers list.");
@@ -22,6 +26,34 @@ xdbi::MultiDbClient::MultiDbClient(const XTypeRegistryPtr registry, const nl::js
     // To be downward compatible with existing configurations, we have to reverse the import_interfaces vector
     // In effect the first/high prioritized interface will become the last but still it will win any conflict cases against the previous ones
     std::reverse(import_interfaces.begin(), import_interfaces.end());
+    // The models are loaded from the import interfaces but written to the main interface, which tracks its own state
+    this->setDirtyTracking(false);
+    import_memberships.resize(import_interfaces.size());
+    import_membership_updates.resize(import_interfaces.size());
+    import_membership_refreshes.resize(import_interfaces.size());
+    statistics->entries.resize(import_interfaces.size());
+    if (multi_config.contains("deadline_ms"))
+        deadline_ms = std::chrono::milliseconds(multi_config["deadline_ms"].get<std::int64_t>());
+    if (multi_config.contains("membership_ttl_ms"))
+        membership_ttl = std::chrono::milliseconds(multi_config["membership_ttl_ms"].get<std::int64_t>());
+    if (multi_config.contains("negative_cache_size"))
+        unresolved.setCapacity(multi_config["negative_cache_size"].get<std::size_t>());
+    if (multi_config.contains("negative_cache_ttl_ms"))
+        unresolved.setTTL(std::chrono::milliseconds(multi_config["negative_cache_ttl_ms"].get<std::int64_t>()));
+    if (multi_config.contains("routing"))
+    {
+        for (auto &rule : multi_config["routing"])
+        {
+            Route route{std::regex(rule.at("classname").get<std::string>()), rule.at("import_servers").get<std::set<std::string>>()};
+            for (auto &name : route.import_servers)
+            {
+                if (std::none_of(import_interfaces.begin(), import_interfaces.end(), [&](const DbInterfacePtr &interface)
+                                 { return this->nameOf(interface) == name; }))
+                    throw std::runtime_error("Invalid config; routing refers to an unknown import server \'" + name + '\'');
+            }
+            routes.push_back(std::move(route));
+        }
+    }
     if (multi_config.contains("main_server") && !multi_config["main_server"].empty())
     {
         main_interface = DbInterface::from_config(registry, multi_config["main_server"], false);
@@ -36,6 +68,7 @@ xdbi::MultiDbClient::MultiDbClient(const XTypeRegistryPtr registry, const nl::js
 void xdbi::MultiDbClient::setWorkingGraph(const std::string &graph)
 {
     main_interface->setWorkingGraph(graph);
+    this->invalidateCaches();
 }
 
 std::string xdbi::MultiDbClient::getWorkingGraph()
@@ -47,9 +80,10 @@ void xdbi::MultiDbClient::setImportServerWorkingGraph(const std::string &name,co
 {
     for (auto &interface : import_interfaces)
     {
-        if (interface->getConfig()["name"] == name)
+        if (this->nameOf(interface) == name)
         {
             interface->setWorkingGraph(graph);
+            this->invalidateCaches();
             return;
         }
     }
@@ -71,7 +105,7 @@ std::string xdbi::MultiDbClient::getImportServerWorkingGraph(const std::string &
 
      for (auto &interface : import_interfaces)
      {
-        if (interface->getConfig()["name"] == name)
+        if (this->nameOf(interface) == name)
         {
           return interface->getWorkingGraph();
         }
@@ -90,7 +124,7 @@ bool xdbi::MultiDbClient::isReady()
     {
         if (!interface->isReady())
         {
-            std::cout<<"MultiDbClient::isReady: import interface \'"+nl::to_string(interface->getConfig()["name"])+"\' is not ready"<<std::endl;
+            std::cout<<"MultiDbClient::isReady: import interface \'"+this->nameOf(interface)+"\' is not ready"<<std::endl;
             return false;
         }
     }
@@ -100,86 +134,489 @@ bool xdbi::MultiDbClient::isReady()
 
 XTypePtr xdbi::MultiDbClient::load(const std::string &uri, const std::string &classname)
 {
-    XTypePtr last_found;
-    // We search the import databases in the look-up order specified by the order of interfaces in import_servers
-    for (auto &interface : import_interfaces)
+    return this->importSpec(this->loadSpec(uri, classname));
+}
+
+nl::json xdbi::MultiDbClient::loadSpec(const std::string &uri, const std::string &classname)
+{
+    bool partial = false;
+    return this->loadSpec(uri, classname, partial);
+}
+
+nl::json xdbi::MultiDbClient::loadSpec(const std::string &uri, const std::string &classname, bool &partial)
+{
+    partial = false;
+    // Dangling references would otherwise be looked up in every backend again and again
+    if (unresolved.contains(uri))
+        return nl::json();
+    // We query all import databases which may hold the uri concurrently,
+    // but evaluate the results in the look-up order specified by the order of interfaces in import_servers
+    const auto until = this->deadline();
+    const std::vector<DbInterfacePtr> candidates = this->candidatesFor(uri, classname, until);
+    auto results = forEachInterface(candidates, [uri, classname](const DbInterfacePtr &interface) {
+        return interface->loadSpec(uri, classname);
+    });
+    nl::json last_found;
+    bool missed = false;
+    for (std::size_t i = 0; i < results.size(); i++)
     {
-        XTypePtr found(interface->load(uri, classname));
+        if (!this->awaitResult(results[i], candidates[i], until))
+        {
+            missed = true;
+            continue;
+        }
+        nl::json found = results[i].get();
+        if (!found.empty())
+            this->recordHit(candidates[i]);
         // 20240405 MS: We cannot break any longer and have to load any match in any of the import interfaces
         // The last match will win (overwrite already found stuff).
         // Since we have reversed the import_interfaces before, this change should not be visible to the user
-        if (found)
-            last_found = found;
+        if (!found.empty())
+            last_found = std::move(found);
     }
+    // A miss is only remembered, if no routing rule restricted the search (otherwise another classname might still find it)
+    // The same holds for misses caused by interfaces which did not answer in time
+    if (last_found.empty() && !missed && this->routeFor(classname).size() == import_interfaces.size())
+        unresolved.insert(uri);
+    partial = missed;
     return last_found;
 }
 
+std::vector<DbInterfacePtr> xdbi::MultiDbClient::routeFor(const std::string &classname) const
+{
+    if (classname.empty())
+        return import_interfaces;
+    for (const auto &route : routes)
+    {
+        if (!std::regex_match(classname, route.classname))
+            continue;
+        std::vector<DbInterfacePtr> routed;
+        std::copy_if(import_interfaces.begin(), import_interfaces.end(), std::back_inserter(routed), [&](const DbInterfacePtr &interface)
+                     { return route.import_servers.count(this->nameOf(interface)) > 0; });
+        return routed;
+    }
+    return import_interfaces;
+}
+
+std::vector<DbInterfacePtr> xdbi::MultiDbClient::candidatesFor(const std::string &uri, const std::string &classname, const std::chrono::steady_clock::time_point &until)
+{
+    const std::vector<DbInterfacePtr> routed = this->routeFor(classname);
+    if (membership_ttl.count() < 0)
+        return routed;
+    this->refreshMemberships(until);
+    std::vector<DbInterfacePtr> candidates;
+    std::lock_guard<std::mutex> lock(membership_mutex);
+    const auto now = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < import_interfaces.size(); i++)
+    {
+        if (std::find(routed.begin(), routed.end(), import_interfaces[i]) == routed.end())
+            continue;
+        // Only an up to date summary is trusted (its refresh might have missed the deadline)
+        const bool fresh = now - import_membership_updates[i] < membership_ttl;
+        if (!fresh || !import_memberships[i] || import_memberships[i]->mayContain(uri))
+            candidates.push_back(import_interfaces[i]);
+    }
+    return candidates;
+}
+
+void xdbi::MultiDbClient::refreshMemberships(const std::chrono::steady_clock::time_point &until)
+{
+    std::vector<std::size_t> stale;
+    std::vector<std::shared_future<MembershipPtr>> refreshed;
+    {
+        std::lock_guard<std::mutex> lock(membership_mutex);
+        const auto now = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < import_interfaces.size(); i++)
+        {
+            // A refresh which is still running (e.g. of a slow remote) is awaited instead of starting another one
+            if (!import_membership_refreshes[i].valid())
+            {
+                if (now - import_membership_updates[i] < membership_ttl)
+                    continue;
+                import_membership_refreshes[i] = Executor::shared().submit([interface = import_interfaces[i], known = import_memberships[i]]() {
+                    return interface->getMembership(known);
+                }).share();
+            }
+            stale.push_back(i);
+            refreshed.push_back(import_membership_refreshes[i]);
+        }
+    }
+    for (std::size_t k = 0; k < stale.size(); k++)
+    {
+        if (until != std::chrono::steady_clock::time_point::max() && refreshed[k].wait_until(until) != std::future_status::ready)
+            continue;
+        MembershipPtr membership;
+        try
+        {
+            membership = refreshed[k].get();
+        }
+        catch (const std::exception &e)
+        {
+            // Without a summary the interface simply gets queried every time
+            LOGE("MultiDbClient: Could not refresh membership of import interface " << this->nameOf(import_interfaces[stale[k]]) << ": " << e.what());
+        }
+        std::lock_guard<std::mutex> lock(membership_mutex);
+        // A new generation means that uris might have been added, so previous misses are not valid anymore
+        if (import_memberships[stale[k]] && membership != import_memberships[stale[k]])
+            unresolved.clear();
+        import_memberships[stale[k]] = membership;
+        import_membership_updates[stale[k]] = std::chrono::steady_clock::now();
+        import_membership_refreshes[stale[k]] = std::shared_future<MembershipPtr>();
+    }
+}
+
+void xdbi::MultiDbClient::invalidateMemberships()
+{
+    std::lock_guard<std::mutex> lock(membership_mutex);
+    std::fill(import_membership_updates.begin(), import_membership_updates.end(), std::chrono::steady_clock::time_point());
+}
+
+void xdbi::MultiDbClient::invalidateCaches()
+{
+    unresolved.clear();
+    this->invalidateMemberships();
+    if (main_interface)
+        main_interface->invalidateCaches();
+    for (auto &interface : import_interfaces)
+    {
+        interface->invalidateCaches();
+    }
+}
+
+// NOTE: The main interface might also be (a different instance of) one of the import interfaces, so we have to invalidate all caches on any write
+
 bool xdbi::MultiDbClient::clear()
 {
-    return main_interface->clear();
+    const bool result = main_interface->clear();
+    this->invalidateCaches();
+    return result;
 }
 
 bool xdbi::MultiDbClient::remove(const std::string &uri)
 {
-    return main_interface->remove(uri);
+    const bool result = main_interface->remove(uri);
+    this->invalidateCaches();
+    return result;
 }
 
 bool xdbi::MultiDbClient::add(std::vector<XTypePtr> xtypes, const int max_depth)
 {
-    return main_interface->add(xtypes, max_depth);
+    const bool result = main_interface->add(xtypes, max_depth);
+    this->invalidateCaches();
+    return result;
 }
 
 bool xdbi::MultiDbClient::add(nl::json xtypes)
 {
-    return main_interface->add(xtypes);
+    const bool result = main_interface->add(xtypes);
+    this->invalidateCaches();
+    return result;
 }
 
 bool xdbi::MultiDbClient::update(std::vector<XTypePtr> xtypes, const int max_depth)
 {
-    return main_interface->update(xtypes, max_depth);
+    const bool result = main_interface->update(xtypes, max_depth);
+    this->invalidateCaches();
+    return result;
 }
 
 bool xdbi::MultiDbClient::update(nl::json xtypes)
 {
-    return main_interface->update(xtypes);
+    const bool result = main_interface->update(xtypes);
+    this->invalidateCaches();
+    return result;
+}
+
+bool xdbi::MultiDbClient::patch(const std::string &uri, const nl::json &patch)
+{
+    const bool result = main_interface->patch(uri, patch);
+    this->invalidateCaches();
+    return result;
 }
 
 std::vector<XTypePtr> xdbi::MultiDbClient::find(const std::string &classname, const nl::json &properties)
 {
-    std::set<std::string> known;
-    // The semantics of find are as follows:
+    const nl::json models = this->findSpecs(classname, properties);
     std::vector<XTypePtr> out;
-    // We search the import databases in the look-up order specified by the order of interfaces in import_servers
-    std::vector<XTypePtr> interface_out;
-    for (auto &interface : import_interfaces)
+    out.reserve(models.size());
+    std::transform(models.begin(), models.end(), std::back_inserter(out), [&](const nl::json &model)
+                   { return this->importSpec(model); });
+    return out;
+}
+
+nl::json xdbi::MultiDbClient::findSpecs(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields)
+{
+    bool partial = false;
+    return this->findSpecs(classname, properties, fields, partial);
+}
+
+nl::json xdbi::MultiDbClient::findSpecs(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields, bool &partial)
+{
+    const std::vector<DbInterfacePtr> interfaces = this->routeFor(classname);
+    const auto until = this->deadline();
+    // A single interface owns all of its models, so there is nothing to resolve
+    if (interfaces.size() == 1)
+    {
+        auto results = forEachInterface(interfaces, [classname, properties, fields](const DbInterfacePtr &interface) {
+            return interface->findSpecs(classname, properties, fields);
+        });
+        partial = !this->awaitResult(results[0], interfaces[0], until);
+        if (partial)
+            return nl::json::array();
+        nl::json out = results[0].get();
+        if (!out.empty())
+            this->recordHit(interfaces[0]);
+        return out;
+    }
+    // The semantics of find are as follows:
+    // First we only collect the matching uris of all (routed) import databases (concurrently) ...
+    auto matches = forEachInterface(interfaces, [classname, properties](const DbInterfacePtr &interface) {
+        return interface->uris(classname, properties);
+    });
+    bool missed = false;
+    std::vector<std::set<std::string>> matching_uris(matches.size());
+    for (std::size_t i = 0; i < matches.size(); i++)
     {
-        std::vector<XTypePtr> _out = interface->find(classname, properties);
-        for (auto& xtype : _out)
+        if (!this->awaitResult(matches[i], interfaces[i], until))
         {
-            const std::string& _uri(xtype->uri());
-            if (known.count(_uri))
+            missed = true;
+            continue;
+        }
+        matching_uris[i] = matches[i].get();
+        if (!matching_uris[i].empty())
+            this->recordHit(interfaces[i]);
+    }
+    // ... then we resolve the owner of every uri in the same way as load() does: the last match wins.
+    // Since we have reversed the import_interfaces before, the first interface in import_servers has the highest priority
+    std::map<std::string, std::size_t> owners;
+    for (std::size_t i = 0; i < matching_uris.size(); i++)
+    {
+        for (const auto &uri : matching_uris[i])
+            owners[uri] = i;
+    }
+    std::vector<std::vector<std::string>> owned(interfaces.size());
+    for (const auto &owner : owners)
+        owned[owner.second].push_back(owner.first);
+    // Finally, only the interfaces owning at least one uri get asked for their models.
+    // The query is restricted to the owned uris (unless it pins the uris itself), so only these are transferred.
+    std::vector<DbInterfacePtr> owning;
+    std::vector<std::size_t> owning_index;
+    auto queries = std::make_shared<std::map<DbInterfacePtr, nl::json>>();
+    for (std::size_t i = 0; i < interfaces.size(); i++)
+    {
+        if (owned[i].empty())
+            continue;
+        owning.push_back(interfaces[i]);
+        owning_index.push_back(i);
+        nl::json query = properties.is_null() ? nl::json::object() : properties;
+        if (!query.contains("uri"))
+            query["uri"] = {{"$in", owned[i]}};
+        (*queries)[interfaces[i]] = std::move(query);
+    }
+    auto results = forEachInterface(owning, [classname, queries, fields](const DbInterfacePtr &interface) {
+        return interface->findSpecs(classname, queries->at(interface), fields);
+    });
+    nl::json out = nl::json::array();
+    for (std::size_t k = 0; k < results.size(); k++)
+    {
+        if (!this->awaitResult(results[k], owning[k], until))
+        {
+            missed = true;
+            continue;
+        }
+        nl::json _out = results[k].get();
+        // The owners are asked a second time, so this call is counted as a hit as well
+        if (!_out.empty())
+            this->recordHit(owning[k]);
+        for (auto &model : _out)
+        {
+            auto owner = owners.find(model["uri"].get<std::string>());
+            // Models which are owned by another interface (or appeared after we collected the uris) are skipped
+            if (owner == owners.end() || owner->second != owning_index[k])
                 continue;
-            // ... BUT we only insert UNKNOWN xtypes in the result
-            out.push_back(xtype);
-            known.insert(_uri);
+            // Every model gets returned exactly once
+            owners.erase(owner);
+            out.push_back(std::move(model));
         }
     }
-    // In the end, we have all matching xtypes in the result but no duplicate Xtypes
+    // In the end, we have all matching models in the result but no duplicates
+    partial = missed;
     return out;
 }
 
 std::set<std::string> xdbi::MultiDbClient::uris(const std::string &classname, const nl::json &properties)
+{
+    bool partial = false;
+    return this->uris(classname, properties, partial);
+}
+
+std::set<std::string> xdbi::MultiDbClient::uris(const std::string &classname, const nl::json &properties, bool &partial)
 {
     // When we look for all uris, we use a set to simply merge them (no duplicates)
     std::set<std::string> results;
-    for (auto &interface : import_interfaces)
+    const std::vector<DbInterfacePtr> interfaces = this->routeFor(classname);
+    const auto until = this->deadline();
+    auto futures = forEachInterface(interfaces, [classname, properties](const DbInterfacePtr &interface) {
+        return interface->uris(classname, properties);
+    });
+    bool missed = false;
+    for (std::size_t i = 0; i < futures.size(); i++)
     {
-        std::set<std::string> _out = interface->uris(classname, properties);
+        if (!this->awaitResult(futures[i], interfaces[i], until))
+        {
+            missed = true;
+            continue;
+        }
+        std::set<std::string> _out = futures[i].get();
+        if (!_out.empty())
+            this->recordHit(interfaces[i]);
         results.insert(_out.begin(), _out.end());
     }
+    partial = missed;
     return results;
 }
 
+nl::json xdbi::MultiDbClient::findEdgesFrom(const std::vector<std::string> &uris)
+{
+    return this->findEdges(uris, true);
+}
+
+nl::json xdbi::MultiDbClient::findEdgesTo(const std::vector<std::string> &uris)
+{
+    return this->findEdges(uris, false);
+}
+
+nl::json xdbi::MultiDbClient::findEdges(const std::vector<std::string> &uris, const bool from)
+{
+    const std::vector<DbInterfacePtr> interfaces = this->routeFor("");
+    const auto until = this->deadline();
+    auto futures = forEachInterface(interfaces, [uris, from](const DbInterfacePtr &interface) {
+        return from ? interface->findEdgesFrom(uris) : interface->findEdgesTo(uris);
+    });
+    std::vector<nl::json> found(interfaces.size());
+    std::set<std::string> sources;
+    for (std::size_t i = 0; i < futures.size(); i++)
+    {
+        if (!this->awaitResult(futures[i], interfaces[i], until))
+            continue;
+        found[i] = futures[i].get();
+        if (!found[i].empty())
+            this->recordHit(interfaces[i]);
+        for (const auto &[source, _] : found[i].items())
+            sources.insert(source);
+    }
+    if (sources.empty())
+        return nl::json::object();
+    // Like in load() the edges of a source are only taken from its owner (the last interface holding it).
+    // So we resolve the owners of all sources, because the owner might hold a source without (these) edges.
+    const std::vector<std::string> candidates(sources.begin(), sources.end());
+    auto holding = forEachInterface(interfaces, [candidates](const DbInterfacePtr &interface) {
+        return interface->uris("", nl::json{{"uri", {{"$in", candidates}}}});
+    });
+    std::map<std::string, std::size_t> owners;
+    for (std::size_t i = 0; i < holding.size(); i++)
+    {
+        if (!this->awaitResult(holding[i], interfaces[i], until))
+            continue;
+        const std::set<std::string> held = holding[i].get();
+        if (!held.empty())
+            this->recordHit(interfaces[i]);
+        for (const auto &uri : held)
+            owners[uri] = i;
+    }
+    nl::json edges = nl::json::object();
+    for (std::size_t i = 0; i < found.size(); i++)
+    {
+        if (found[i].is_null())
+            continue;
+        for (auto &[source, relations] : found[i].items())
+        {
+            auto owner = owners.find(source);
+            if (owner == owners.end() || owner->second != i)
+                continue;
+            edges[source] = std::move(relations);
+        }
+    }
+    return edges;
+}
+
+std::chrono::steady_clock::time_point xdbi::MultiDbClient::deadline() const
+{
+    if (deadline_ms.count() < 0)
+        return std::chrono::steady_clock::time_point::max();
+    return std::chrono::steady_clock::now() + deadline_ms;
+}
+
+std::size_t xdbi::MultiDbClient::indexOf(const DbInterfacePtr &interface) const
+{
+    return std::distance(import_interfaces.begin(), std::find(import_interfaces.begin(), import_interfaces.end(), interface));
+}
+
+std::string xdbi::MultiDbClient::nameOf(const DbInterfacePtr &interface) const
+{
+    // Unnamed import interfaces are named by their position in import_servers (which is the reverse of import_interfaces)
+    return interface->getConfig().value("name", std::to_string(import_interfaces.size() - 1 - this->indexOf(interface)));
+}
+
+std::vector<std::size_t> xdbi::MultiDbClient::bySpeed(const std::vector<DbInterfacePtr> &interfaces) const
+{
+    std::vector<double> mean_latency;
+    mean_latency.reserve(interfaces.size());
+    {
+        std::lock_guard<std::mutex> lock(statistics->mutex);
+        for (auto &interface : interfaces)
+        {
+            const InterfaceStatistics &entry(statistics->entries[this->indexOf(interface)]);
+            mean_latency.push_back(entry.calls ? entry.latency.count() / entry.calls : 0.);
+        }
+    }
+    std::vector<std::size_t> order(interfaces.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b)
+                     { return mean_latency[a] < mean_latency[b]; });
+    return order;
+}
+
+void xdbi::MultiDbClient::recordHit(const DbInterfacePtr &interface)
+{
+    std::lock_guard<std::mutex> lock(statistics->mutex);
+    statistics->entries[this->indexOf(interface)].hits++;
+}
+
+void xdbi::MultiDbClient::StatisticsTable::record(const std::size_t index, const std::chrono::steady_clock::duration &latency, const bool error)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[index].calls++;
+    entries[index].latency += latency;
+    if (error)
+        entries[index].errors++;
+}
+
+nl::json xdbi::MultiDbClient::getStatistics()
+{
+    nl::json out = nl::json::object();
+    std::lock_guard<std::mutex> lock(statistics->mutex);
+    for (std::size_t i = 0; i < import_interfaces.size(); i++)
+    {
+        const InterfaceStatistics &entry(statistics->entries[i]);
+        out[this->nameOf(import_interfaces[i])] = {
+            {"calls", entry.calls},
+            {"errors", entry.errors},
+            {"timeouts", entry.timeouts},
+            {"hits", entry.hits},
+            {"mean_latency_ms", entry.calls ? entry.latency.count() / entry.calls : 0.},
+            {"error_rate", entry.calls ? static_cast<double>(entry.errors) / entry.calls : 0.},
+            {"hit_rate", entry.calls ? static_cast<double>(entry.hits) / entry.calls : 0.}};
+    }
+    return out;
+}
+
+void xdbi::MultiDbClient::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(statistics->mutex);
+    std::fill(statistics->entries.begin(), statistics->entries.end(), InterfaceStatistics());
+}
+
 const DbInterfacePtr xdbi::MultiDbClient::getMainInterface()
 {
     return main_interface;
@@ -0,0 +1,72 @@
+#include "NegativeCache.hpp"
+
+namespace xdbi
+{
+    NegativeCache::NegativeCache(const std::size_t capacity, const std::chrono::milliseconds ttl)
+        : capacity(capacity), ttl(ttl)
+    {
+    }
+
+    void NegativeCache::insert(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ttl.count() <= 0 || capacity == 0)
+            return;
+        const clock::time_point now = clock::now();
+        entries[key] = now;
+        insertion_order.emplace_back(key, now);
+        this->evict();
+    }
+
+    bool NegativeCache::contains(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end())
+            return false;
+        if (clock::now() - it->second >= ttl)
+        {
+            entries.erase(it);
+            return false;
+        }
+        return true;
+    }
+
+    void NegativeCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        insertion_order.clear();
+    }
+
+    void NegativeCache::setCapacity(const std::size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->capacity = capacity;
+        this->evict();
+    }
+
+    void NegativeCache::setTTL(const std::chrono::milliseconds ttl)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->ttl = ttl;
+    }
+
+    void NegativeCache::evict()
+    {
+        const clock::time_point now = clock::now();
+        while (!insertion_order.empty())
+        {
+            const auto &[key, inserted] = insertion_order.front();
+            auto it = entries.find(key);
+            // Skip outdated duplicates of keys which have been inserted again (or erased) in the meantime
+            const bool outdated = it == entries.end() || it->second != inserted;
+            const bool expired = now - inserted >= ttl;
+            if (!outdated && !expired && entries.size() <= capacity)
+                break;
+            if (!outdated)
+                entries.erase(it);
+            insertion_order.pop_front();
+        }
+    }
+}
@@ -0,0 +1,356 @@
+#include "Query.hpp"
+#include <algorithm>
+#include <cctype>
+#include <regex>
+#include <stdexcept>
+
+namespace xdbi
+{
+    namespace
+    {
+        bool isOperator(const std::string &key)
+        {
+            return !key.empty() && key[0] == '$';
+        }
+
+        /// Returns true if the condition is an object of operators (and not a plain value to compare with)
+        bool isOperatorObject(const nl::json &condition)
+        {
+            if (!condition.is_object() || condition.empty())
+                return false;
+            const bool first = isOperator(condition.begin().key());
+            for (const auto &[k, _] : condition.items())
+            {
+                if (isOperator(k) != first)
+                    throw std::invalid_argument("Query conditions must not mix operators and plain keys: " + condition.dump());
+            }
+            return first;
+        }
+
+        /// Ordering is only defined between numbers and between strings
+        bool comparable(const nl::json &a, const nl::json &b)
+        {
+            return (a.is_number() && b.is_number()) || (a.is_string() && b.is_string());
+        }
+    }
+
+    Query::Query(const nl::json &query)
+    {
+        m_predicate = this->compile(query);
+        if (query.contains("$edge"))
+            m_relations = this->compileEdges(query["$edge"]);
+        if (m_complete)
+            m_keys.clear();
+        // A pinned uri can be looked up directly instead of scanning the whole class
+        if (query.contains("uri"))
+        {
+            const nl::json &condition = query["uri"];
+            if (condition.is_string())
+                m_uris = std::set<std::string>{condition.get<std::string>()};
+            else if (condition.is_object() && condition.contains("$eq") && condition["$eq"].is_string())
+                m_uris = std::set<std::string>{condition["$eq"].get<std::string>()};
+            else if (condition.is_object() && condition.contains("$in") && condition["$in"].is_array() &&
+                     std::all_of(condition["$in"].begin(), condition["$in"].end(), [](const nl::json &uri) { return uri.is_string(); }))
+                m_uris = condition["$in"].get<std::set<std::string>>();
+        }
+    }
+
+    bool Query::matches(const nl::json &model) const
+    {
+        return m_predicate(model);
+    }
+
+    bool Query::matchesRelations(const nl::json &relations) const
+    {
+        return !m_relations || m_relations(relations);
+    }
+
+    Query::Predicate Query::compile(const nl::json &query)
+    {
+        if (query.is_null())
+            return [](const nl::json &) { return true; };
+        if (!query.is_object())
+            throw std::invalid_argument("Query has to be an object: " + query.dump());
+
+        std::vector<Predicate> predicates;
+        for (const auto &[k, v] : query.items())
+        {
+            if (k == "$and" || k == "$or")
+            {
+                if (!v.is_array())
+                    throw std::invalid_argument(k + " expects an array of queries");
+                std::vector<Predicate> operands;
+                for (const auto &operand : v)
+                    operands.push_back(this->compile(operand));
+                if (k == "$and")
+                    predicates.push_back([operands](const nl::json &model) {
+                        return std::all_of(operands.begin(), operands.end(), [&model](const Predicate &p) { return p(model); });
+                    });
+                else
+                    predicates.push_back([operands](const nl::json &model) {
+                        return std::any_of(operands.begin(), operands.end(), [&model](const Predicate &p) { return p(model); });
+                    });
+            }
+            else if (k == "$not")
+            {
+                const Predicate operand = this->compile(v);
+                predicates.push_back([operand](const nl::json &model) { return !operand(model); });
+            }
+            else if (k == "$edge")
+            {
+                const Predicate edges = this->compileEdges(v);
+                predicates.push_back([edges](const nl::json &model) {
+                    // Relations are either stored under "relations" or directly in the model
+                    return edges(model.contains("relations") ? model["relations"] : model);
+                });
+            }
+            else if (isOperator(k))
+            {
+                throw std::invalid_argument("Unknown query operator " + k);
+            }
+            else
+            {
+                m_keys.insert(k);
+                m_keys.insert(k.substr(0, k.find('.')));
+                const ValuePredicate condition = this->compileCondition(v);
+                predicates.push_back([path = k, condition](const nl::json &model) { return condition(resolve(model, path)); });
+            }
+        }
+        if (predicates.size() == 1)
+            return predicates.front();
+        return [predicates](const nl::json &model) {
+            return std::all_of(predicates.begin(), predicates.end(), [&model](const Predicate &p) { return p(model); });
+        };
+    }
+
+    Query::ValuePredicate Query::compileCondition(const nl::json &condition)
+    {
+        if (!isOperatorObject(condition))
+            return [condition](const nl::json *value) { return value && *value == condition; };
+
+        std::vector<ValuePredicate> predicates;
+        for (const auto &[op, operand] : condition.items())
+        {
+            // The options only modify $regex
+            if (op == "$options")
+                continue;
+            predicates.push_back(this->compileOperator(op, operand, condition));
+        }
+        return [predicates](const nl::json *value) {
+            return std::all_of(predicates.begin(), predicates.end(), [value](const ValuePredicate &p) { return p(value); });
+        };
+    }
+
+    Query::ValuePredicate Query::compileOperator(const std::string &op, const nl::json &operand, const nl::json &condition)
+    {
+        if (op == "$eq")
+            return [operand](const nl::json *value) { return value && *value == operand; };
+        if (op == "$ne")
+            return [operand](const nl::json *value) { return !value || *value != operand; };
+        if (op == "$gt")
+            return [operand](const nl::json *value) { return value && comparable(*value, operand) && *value > operand; };
+        if (op == "$gte")
+            return [operand](const nl::json *value) { return value && comparable(*value, operand) && *value >= operand; };
+        if (op == "$lt")
+            return [operand](const nl::json *value) { return value && comparable(*value, operand) && *value < operand; };
+        if (op == "$lte")
+            return [operand](const nl::json *value) { return value && comparable(*value, operand) && *value <= operand; };
+        if (op == "$in" || op == "$nin")
+        {
+            if (!operand.is_array())
+                throw std::invalid_argument(op + " expects an array");
+            const bool in = op == "$in";
+            return [operand, in](const nl::json *value) {
+                const bool found = value && std::find(operand.begin(), operand.end(), *value) != operand.end();
+                return found == in;
+            };
+        }
+        if (op == "$prefix")
+        {
+            if (!operand.is_string())
+                throw std::invalid_argument("$prefix expects a string");
+            const std::string prefix = operand.get<std::string>();
+            return [prefix](const nl::json *value) {
+                return value && value->is_string() && value->get_ref<const std::string &>().compare(0, prefix.size(), prefix) == 0;
+            };
+        }
+        if (op == "$regex")
+        {
+            if (!operand.is_string())
+                throw std::invalid_argument("$regex expects a string");
+            auto flags = std::regex::ECMAScript;
+            if (condition.value("$options", "").find('i') != std::string::npos)
+                flags |= std::regex::icase;
+            const std::regex regex(operand.get<std::string>(), flags);
+            return [regex](const nl::json *value) {
+                return value && value->is_string() && std::regex_search(value->get_ref<const std::string &>(), regex);
+            };
+        }
+        if (op == "$exists")
+        {
+            if (!operand.is_boolean())
+                throw std::invalid_argument("$exists expects a boolean");
+            const bool exists = operand.get<bool>();
+            return [exists](const nl::json *value) { return (value != nullptr) == exists; };
+        }
+        if (op == "$not")
+        {
+            const ValuePredicate negated = this->compileCondition(operand);
+            return [negated](const nl::json *value) { return !negated(value); };
+        }
+        throw std::invalid_argument("Unknown query operator " + op);
+    }
+
+    Query::Predicate Query::compileEdges(const nl::json &edges)
+    {
+        if (edges.is_array())
+        {
+            std::vector<Predicate> predicates;
+            for (const auto &edge : edges)
+                predicates.push_back(this->compileEdges(edge));
+            return [predicates](const nl::json &relations) {
+                return std::all_of(predicates.begin(), predicates.end(), [&relations](const Predicate &p) { return p(relations); });
+            };
+        }
+        if (!edges.is_object())
+            throw std::invalid_argument("$edge expects an object or an array of objects");
+        for (const auto &[k, _] : edges.items())
+        {
+            if (k != "relation" && k != "target" && k != "edge_properties")
+                throw std::invalid_argument("Unknown $edge key " + k);
+        }
+
+        const std::string relation = edges.value("relation", "");
+        m_keys.insert("relations");
+        if (relation.empty())
+            m_complete = true; // Relations might be stored directly in the model under any key
+        else
+            m_keys.insert(relation);
+        const ValuePredicate target = edges.contains("target") ? this->compileCondition(edges["target"]) : ValuePredicate();
+        const Predicate edge_properties = edges.contains("edge_properties") ? this->compile(edges["edge_properties"]) : Predicate();
+        return [relation, target, edge_properties](const nl::json &relations) {
+            if (!relations.is_object())
+                return false;
+            for (const auto &[k, v] : relations.items())
+            {
+                if (!v.is_array() || (!relation.empty() && k != relation))
+                    continue;
+                for (const auto &edge : v)
+                {
+                    if (!edge.is_object() || !edge.contains("target") || !edge.contains("edge_properties"))
+                        continue;
+                    if (target && !target(&edge["target"]))
+                        continue;
+                    if (edge_properties && !edge_properties(edge["edge_properties"]))
+                        continue;
+                    return true;
+                }
+            }
+            return false;
+        };
+    }
+
+    SortOrder::SortOrder(const std::vector<std::string> &sort)
+    {
+        for (const auto &key : sort)
+        {
+            const bool descending = !key.empty() && key[0] == '-';
+            const std::string path = (!key.empty() && (key[0] == '-' || key[0] == '+')) ? key.substr(1) : key;
+            if (path.empty())
+                throw std::invalid_argument("Empty sort key");
+            m_sort.emplace_back(path, descending);
+        }
+    }
+
+    nl::json SortOrder::valuesOf(const nl::json &model) const
+    {
+        nl::json values = nl::json::array();
+        for (const auto &[path, _] : m_sort)
+        {
+            const nl::json *value = Query::resolve(model, path);
+            values.push_back(value ? *value : nl::json());
+        }
+        values.push_back(model["uri"]);
+        return values;
+    }
+
+    bool SortOrder::before(const nl::json &a, const nl::json &b) const
+    {
+        for (std::size_t i = 0; i < m_sort.size(); i++)
+        {
+            if (a[i] == b[i])
+                continue;
+            if (a[i].is_null())
+                return false;
+            if (b[i].is_null())
+                return true;
+            return m_sort[i].second ? b[i] < a[i] : a[i] < b[i];
+        }
+        return a.back() < b.back();
+    }
+
+    std::set<std::string> SortOrder::keys() const
+    {
+        std::set<std::string> keys{"properties"};
+        for (const auto &[path, _] : m_sort)
+        {
+            keys.insert(path);
+            keys.insert(path.substr(0, path.find('.')));
+        }
+        return keys;
+    }
+
+    std::vector<std::string> SortOrder::fieldsFor(const std::vector<std::string> &fields) const
+    {
+        // Without a projection, the complete models are fetched anyway
+        if (fields.empty())
+            return fields;
+        const std::set<std::string> sort_keys = this->keys();
+        std::vector<std::string> fetched(sort_keys.begin(), sort_keys.end());
+        fetched.insert(fetched.end(), fields.begin(), fields.end());
+        return fetched;
+    }
+
+    const nl::json *Query::resolve(const nl::json &model, const std::string &path)
+    {
+        // Properties are either stored under "properties" or directly in the model
+        const nl::json &properties = model.contains("properties") ? model["properties"] : model;
+        for (const nl::json *root : {&properties, &model})
+        {
+            // Keys containing dots take precedence over nested paths
+            if (root->is_object())
+            {
+                auto it = root->find(path);
+                if (it != root->end())
+                    return &(*it);
+            }
+            const nl::json *current = root;
+            std::size_t start = 0;
+            while (current)
+            {
+                const std::size_t end = path.find('.', start);
+                const std::string segment = path.substr(start, end == std::string::npos ? std::string::npos : end - start);
+                if (current->is_object())
+                {
+                    auto it = current->find(segment);
+                    current = it != current->end() ? &(*it) : nullptr;
+                }
+                else if (current->is_array() && !segment.empty() && segment.size() < 10 && std::all_of(segment.begin(), segment.end(), ::isdigit) &&
+                         std::stoul(segment) < current->size())
+                {
+                    current = &(*current)[std::stoul(segment)];
+                }
+                else
+                {
+                    current = nullptr;
+                }
+                if (end == std::string::npos)
+                    break;
+                start = end + 1;
+            }
+            if (current)
+                return current;
+        }
+        return nullptr;
+    }
+}
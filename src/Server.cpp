@@ -20,8 +20,14 @@ xdbi::Server::Server(const fs::path &dbPath, std::string dbAddress, int dbPort)
     handlers["remove"] = &xdbi::Server::remove;
     handlers["add"] = &xdbi::Server::add;
     handlers["update"] = &xdbi::Server::update;
+    handlers["patch"] = &xdbi::Server::patch;
     handlers["find"] = &xdbi::Server::find;
+    handlers["count"] = &xdbi::Server::count;
     handlers["ping"] = &xdbi::Server::ping;
+    handlers["membership"] = &xdbi::Server::membership;
+    handlers["subgraph"] = &xdbi::Server::subgraph;
+    handlers["edges"] = &xdbi::Server::edges;
+    handlers["traverse"] = &xdbi::Server::traverse;
 }
 
 xdbi::Server::~Server()
@@ -229,6 +235,38 @@ crow::response xdbi::Server::update(const crow::request &req, const nl::json &db
         return res;
     }
 }
+crow::response xdbi::Server::patch(const crow::request &req, const nl::json &dbRequest)
+{
+    try
+    {
+        if (!dbRequest.contains("uri"))
+            throw std::runtime_error("Could not find uri field in request");
+        if (!dbRequest.contains("patch"))
+            throw std::runtime_error("Could not find patch field in request");
+        if (!dbRequest.contains("graph"))
+            throw std::runtime_error("No graph specified");
+        backend->setWorkingGraph(dbRequest["graph"]);
+
+        const bool r = backend->patch(dbRequest["uri"].get<std::string>(), dbRequest["patch"]);
+        const nl::json response = {
+            {"status", "finished"},
+            {"result", r}};
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+    catch (const std::exception &e)
+    {
+        const nl::json response = {
+            {"status", "error"},
+            {"message", e.what()},
+        };
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+}
+
 crow::response xdbi::Server::find(const crow::request &req, const nl::json &dbRequest)
 {
     try
@@ -241,7 +279,215 @@ crow::response xdbi::Server::find(const crow::request &req, const nl::json &dbRe
             throw std::runtime_error("No graph specified");
         backend->setWorkingGraph(dbRequest["graph"]);
 
-        const nl::json r = backend->find(dbRequest["classname"].get<std::string>(), dbRequest["properties"]);
+        // Older clients do not send a projection (or a limit), so they get the complete models
+        const std::vector<std::string> fields = dbRequest.value("fields", std::vector<std::string>());
+        if (dbRequest.contains("sort"))
+        {
+            // Only the first limit models (top-k) are kept and sent
+            const nl::json r = backend->findSorted(dbRequest["classname"].get<std::string>(), dbRequest["properties"],
+                                                   dbRequest["sort"].get<std::vector<std::string>>(), dbRequest.value("limit", std::size_t(0)), fields);
+            // The flag tells clients that the result is sorted (older servers ignore the sort keys)
+            const nl::json response = {
+                {"status", "finished"},
+                {"sorted", true},
+                {"result", r}};
+            crow::response res(response.dump());
+            res.set_header("Content-Type", "application/json");
+            return res;
+        }
+        if (dbRequest.contains("limit"))
+        {
+            const nl::json page = backend->findPage(dbRequest["classname"].get<std::string>(), dbRequest["properties"],
+                                                    dbRequest["limit"].get<std::size_t>(), dbRequest.value("offset", std::size_t(0)),
+                                                    dbRequest.value("cursor", std::string()), fields);
+            const nl::json response = {
+                {"status", "finished"},
+                {"result", page["models"]},
+                {"cursor", page["cursor"]}};
+            crow::response res(response.dump());
+            res.set_header("Content-Type", "application/json");
+            return res;
+        }
+        // The models are serialized one by one while scanning, so the complete result never exists as nl::json next to its dump
+        // NOTE: crow sends the body in one piece, so the response is not streamed to the client
+        std::string body = R"({"status":"finished","result":[)";
+        bool first = true;
+        backend->findEach(dbRequest["classname"].get<std::string>(), dbRequest["properties"], fields, [&](const nl::json &model) {
+            if (!first)
+                body += ',';
+            first = false;
+            body += model.dump();
+        });
+        body += "]}";
+        crow::response res(std::move(body));
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+    catch (const std::exception &e)
+    {
+        const nl::json response = {
+            {"status", "error"},
+            {"message", e.what()},
+        };
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+}
+
+crow::response xdbi::Server::count(const crow::request &req, const nl::json &dbRequest)
+{
+    try
+    {
+        if (!dbRequest.contains("graph"))
+            throw std::runtime_error("No graph specified");
+        backend->setWorkingGraph(dbRequest["graph"]);
+
+        // Only the numbers are sent, not the models
+        const std::string classname = dbRequest.value("classname", "");
+        const nl::json properties = dbRequest.value("properties", nl::json::object());
+        nl::json r;
+        if (dbRequest.contains("group_by"))
+            r = backend->groupCount(classname, dbRequest["group_by"].get<std::string>(), properties);
+        else
+            r = backend->count(classname, properties);
+        const nl::json response = {
+            {"status", "finished"},
+            {"result", r}};
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+    catch (const std::exception &e)
+    {
+        const nl::json response = {
+            {"status", "error"},
+            {"message", e.what()},
+        };
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+}
+
+crow::response xdbi::Server::subgraph(const crow::request &req, const nl::json &dbRequest)
+{
+    try
+    {
+        if (!dbRequest.contains("uri"))
+            throw std::runtime_error("Could not find uri field in request");
+        if (!dbRequest.contains("graph"))
+            throw std::runtime_error("No graph specified");
+        backend->setWorkingGraph(dbRequest["graph"]);
+
+        const nl::json r = backend->loadSubgraph(dbRequest["uri"].get<std::string>(),
+                                                 dbRequest.value("max_depth", -1),
+                                                 dbRequest.value("relations", std::set<std::string>()));
+        const nl::json response = {
+            {"status", "finished"},
+            {"result", r}};
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+    catch (const std::exception &e)
+    {
+        const nl::json response = {
+            {"status", "error"},
+            {"message", e.what()},
+        };
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+}
+
+crow::response xdbi::Server::edges(const crow::request &req, const nl::json &dbRequest)
+{
+    try
+    {
+        if (!dbRequest.contains("uris"))
+            throw std::runtime_error("Could not find uris field in request");
+        if (!dbRequest.contains("graph"))
+            throw std::runtime_error("No graph specified");
+        backend->setWorkingGraph(dbRequest["graph"]);
+
+        // Only the edges are sent, not the models they are stored in
+        const std::vector<std::string> uris = dbRequest["uris"].get<std::vector<std::string>>();
+        const std::string direction = dbRequest.value("direction", "from");
+        nl::json r;
+        if (direction == "from")
+            r = backend->findEdgesFrom(uris);
+        else if (direction == "to")
+            r = backend->findEdgesTo(uris);
+        else
+            throw std::runtime_error("Unknown edge direction " + direction);
+        const nl::json response = {
+            {"status", "finished"},
+            {"result", r}};
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+    catch (const std::exception &e)
+    {
+        const nl::json response = {
+            {"status", "error"},
+            {"message", e.what()},
+        };
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+}
+
+crow::response xdbi::Server::traverse(const crow::request &req, const nl::json &dbRequest)
+{
+    try
+    {
+        if (!dbRequest.contains("uri"))
+            throw std::runtime_error("Could not find uri field in request");
+        if (!dbRequest.contains("graph"))
+            throw std::runtime_error("No graph specified");
+        backend->setWorkingGraph(dbRequest["graph"]);
+
+        const std::string order = dbRequest.value("order", "bfs");
+        if (order != "bfs" && order != "dfs")
+            throw std::runtime_error("Unknown traversal order " + order);
+        const nl::json r = backend->traverse(dbRequest["uri"].get<std::string>(),
+                                             dbRequest.value("relations", std::set<std::string>()),
+                                             dbRequest.value("direction", "out"),
+                                             dbRequest.value("max_depth", -1),
+                                             order == "dfs",
+                                             dbRequest.value("uris_only", false));
+        const nl::json response = {
+            {"status", "finished"},
+            {"result", r}};
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+    catch (const std::exception &e)
+    {
+        const nl::json response = {
+            {"status", "error"},
+            {"message", e.what()},
+        };
+        crow::response res(response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+}
+
+crow::response xdbi::Server::membership(const crow::request &req, const nl::json &dbRequest)
+{
+    try
+    {
+        if (!dbRequest.contains("graph"))
+            throw std::runtime_error("No graph specified");
+        backend->setWorkingGraph(dbRequest["graph"]);
+
+        const nl::json r = backend->getMembership(dbRequest.contains("generation") ? dbRequest["generation"].get<std::size_t>() : 0);
         const nl::json response = {
             {"status", "finished"},
             {"result", r}};
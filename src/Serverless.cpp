@@ -12,6 +12,7 @@ xdbi::Serverless::Serverless(const XTypeRegistryPtr registry, const fs::path &db
 void xdbi::Serverless::setWorkingGraph(const std::string &graph)
 {
     backend->setWorkingGraph(graph);
+    this->forgetSynced();
 }
 
 std::string xdbi::Serverless::getWorkingGraph()
@@ -22,6 +23,7 @@ std::string xdbi::Serverless::getWorkingGraph()
 void xdbi::Serverless::setWorkingDbPath(const fs::path &db_path)
 {
     backend->setWorkingDbPath(db_path);
+    this->forgetSynced();
 }
 
 fs::path xdbi::Serverless::getWorkingDbPath()
@@ -41,16 +43,26 @@ bool xdbi::Serverless::isReady()
 }
 
 XTypePtr xdbi::Serverless::load(const std::string &uri, const std::string &classname)
+{
+    return this->importSpec(this->loadSpec(uri, classname));
+}
+
+nl::json xdbi::Serverless::loadSpec(const std::string &uri, const std::string &classname)
 {
     this->checkReadiness();
-    nl::json spec = this->backend->load(uri);
+    return this->backend->load(uri);
+}
 
-    return XType::import_from(spec, registry.lock());
+nl::json xdbi::Serverless::loadSubgraphSpecs(const std::string &uri, const int max_depth, const std::set<std::string> &relations)
+{
+    this->checkReadiness();
+    return this->backend->loadSubgraph(uri, max_depth, relations);
 }
 
 bool xdbi::Serverless::clear()
 {
     this->checkReadiness();
+    this->forgetSynced();
     return this->backend->clear();
 }
 
@@ -58,6 +70,8 @@ bool xdbi::Serverless::remove(const std::string &uri)
 {
     this->checkReadiness();
     this->checkWriteable();
+    // Removing might cascade to other models due to their delete policies
+    this->forgetSynced();
     return this->backend->remove(uri);
 }
 
@@ -65,22 +79,14 @@ bool xdbi::Serverless::add(std::vector<XTypePtr> xtypes, const int max_depth)
 {
     this->checkReadiness();
     this->checkWriteable();
-    nl::json models;
-    for (auto xtype : xtypes)
-    {
-        std::map< std::string, nl::json> specs = xtype->export_to(max_depth);
-        for (const auto &[_,spec] : specs)
-        {
-            models.push_back(spec);
-        }
-    }
-    return this->add(models);
+    return this->add(this->exportSpecs(xtypes, max_depth));
 }
 
 bool xdbi::Serverless::add(nl::json xtypes)
 {
     this->checkReadiness();
     this->checkWriteable();
+    this->forgetSynced(xtypes);
     return this->backend->add(xtypes);
 }
 
@@ -88,15 +94,11 @@ bool xdbi::Serverless::update(std::vector<XTypePtr> xtypes, const int max_depth)
 {
     this->checkReadiness();
     this->checkWriteable();
-    nl::json models;
-    for (const auto &xtype : xtypes)
-    {
-        std::map< std::string, nl::json> specs = xtype->export_to(max_depth);
-        for (const auto &[_,spec] : specs)
-        {
-            models.push_back(spec);
-        }
-    }
+    // Only the models which changed since they have been loaded or written are sent
+    const nl::json models = this->dropUnchanged(this->exportSpecs(xtypes, max_depth));
+    if (models.empty())
+        return true;
+    // The stored models might differ from the written ones (e.g. by merging), so they are only synced again by the next load
     return this->update(models);
 }
 
@@ -104,30 +106,104 @@ bool xdbi::Serverless::update(nl::json xtypes)
 {
     this->checkReadiness();
     this->checkWriteable();
+    this->forgetSynced(xtypes);
     return this->backend->update(xtypes);
 }
 
+bool xdbi::Serverless::patch(const std::string &uri, const nl::json &patch)
+{
+    this->checkReadiness();
+    this->checkWriteable();
+    this->forgetSynced(nl::json::array({{{"uri", uri}}}));
+    return this->backend->patch(uri, patch);
+}
+
 std::vector<XTypePtr> xdbi::Serverless::find(const std::string &classname, const nl::json &properties)
 {
     this->checkReadiness();
-    nl::json models = this->backend->find(
-        classname,
-        properties);
+    // The backend already provides the complete models, so we import them directly
+    // instead of loading every single one again (which would lock, scan and parse once more).
+    // NOTE: They are imported after the backend released its lock, because importing takes the registry mutex
+    const nl::json models = this->backend->find(classname, properties);
     std::vector<XTypePtr> out;
     out.reserve(models.size());
-    std::transform(models.begin(), models.end(), std::back_inserter(out), [&](nl::json &model)
-                   { return this->load(model["uri"], model["classname"]); });
+    for (const auto &model : models)
+        out.push_back(this->importSpec(model));
     return out;
 }
 
+nl::json xdbi::Serverless::findSpecs(const std::string &classname, const nl::json &properties, const std::vector<std::string> &fields)
+{
+    this->checkReadiness();
+    return this->backend->find(
+        classname,
+        properties,
+        fields);
+}
+
+nl::json xdbi::Serverless::findPage(const std::string &classname, const nl::json &properties, const std::size_t limit, const std::size_t offset,
+                                    const std::string &cursor, const std::vector<std::string> &fields)
+{
+    this->checkReadiness();
+    return this->backend->findPage(classname, properties, limit, offset, cursor, fields);
+}
+
 std::set<std::string> xdbi::Serverless::uris(const std::string &classname, const nl::json &properties)
 {
     this->checkReadiness();
+    // We only need the uris, so the backend does not have to parse the complete models
     nl::json models = this->backend->find(
         classname,
-        properties);
+        properties,
+        {"uri"});
     std::set<std::string> results;
     std::transform(models.begin(), models.end(), std::inserter(results, results.begin()), [&](const nl::json &model)
                    { return model["uri"]; });
     return results;
 }
+
+nl::json xdbi::Serverless::findSorted(const std::string &classname, const nl::json &properties, const std::vector<std::string> &sort,
+                                      const std::size_t limit, const std::vector<std::string> &fields)
+{
+    this->checkReadiness();
+    return this->backend->findSorted(classname, properties, sort, limit, fields);
+}
+
+std::size_t xdbi::Serverless::count(const std::string &classname, const nl::json &properties)
+{
+    this->checkReadiness();
+    return this->backend->count(classname, properties);
+}
+
+nl::json xdbi::Serverless::groupCount(const std::string &classname, const std::string &property, const nl::json &properties)
+{
+    this->checkReadiness();
+    return this->backend->groupCount(classname, property, properties);
+}
+
+nl::json xdbi::Serverless::findEdgesFrom(const std::vector<std::string> &uris)
+{
+    this->checkReadiness();
+    return this->backend->findEdgesFrom(uris);
+}
+
+nl::json xdbi::Serverless::findEdgesTo(const std::vector<std::string> &uris)
+{
+    this->checkReadiness();
+    return this->backend->findEdgesTo(uris);
+}
+
+nl::json xdbi::Serverless::traverse(const std::string &uri, const std::set<std::string> &relations, const std::string &direction,
+                                    const int max_depth, const bool depth_first, const bool uris_only)
+{
+    this->checkReadiness();
+    return this->backend->traverse(uri, relations, direction, max_depth, depth_first, uris_only);
+}
+
+MembershipPtr xdbi::Serverless::getMembership(const MembershipPtr &known)
+{
+    this->checkReadiness();
+    const bool is_known = known && known->graph == this->getWorkingGraph();
+    const nl::json summary = this->backend->getMembership(is_known ? known->generation : 0);
+    return this->parseMembership(this->getWorkingGraph(), summary, known);
+}
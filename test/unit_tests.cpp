@@ -1,10 +1,14 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include <iostream>
+#include <future>
 #include "Client.hpp"
 #include "Serverless.hpp"
+#include "JsonDatabaseBackend.hpp"
 
 #include "MultiDbClient.hpp"
+#include "Query.hpp"
+#include "Models.hpp"
 
 #include <xtypes_generator/XTypeRegistry.hpp>
 #include "ProjectRegistry.hpp"
@@ -35,6 +39,37 @@ nl::json readJson(const std::string &filename)
     return jsonFile;
 }
 
+/// A TestType x which refers to y which refers to z (via a_relation)
+struct TestChain
+{
+    std::shared_ptr<ProjectRegistry> registry = std::make_shared<ProjectRegistry>();
+    std::shared_ptr<TestType> x = registry->instantiate<TestType>();
+    std::shared_ptr<TestType> y = std::make_shared<TestType>();
+    std::shared_ptr<TestType> z = std::make_shared<TestType>();
+    TestChain()
+    {
+        y->set_property("my_uri", "456");
+        z->set_property("my_uri", "789");
+        x->add_fact("a_relation", y);
+        y->add_fact("a_relation", z);
+    }
+};
+
+/// Stores a TestChain via a Serverless and a Client (one after another) and runs check on each of them
+void withTestChain(const std::function<void(DbInterface &, TestChain &)> &check)
+{
+    TestChain chain;
+    Serverless serverless(chain.registry, db_path, graph);
+    Client client(chain.registry, db_address, graph);
+    for (DbInterface *interface : std::vector<DbInterface *>{&serverless, &client})
+    {
+        interface->clear();
+        interface->add({chain.x});
+        check(*interface, chain);
+        interface->clear();
+    }
+}
+
 TEST_CASE("Test database interfaces", "[DbInterface]")
 {
     auto registry = std::make_shared<ProjectRegistry>();
@@ -270,6 +305,516 @@ TEST_CASE("Test database interfaces", "[DbInterface]")
     }
 }
 
+TEST_CASE("Asynchronous database calls", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    auto client = std::make_shared<Serverless>(registry, db_path, graph);
+    client->clearAsync().get();
+    REQUIRE(client->addAsync({x}).get());
+    registry->clear();
+    // Independent queries overlap
+    auto found = client->findAsync(TestType::classname, {});
+    auto uris = client->urisAsync(TestType::classname, {});
+    REQUIRE(found.get().size() == 1);
+    REQUIRE(uris.get().count(x->uri()) == 1);
+    REQUIRE(client->loadAsync(x->uri()).get()->uri() == x->uri());
+    REQUIRE(client->removeAsync(x->uri()).get());
+    REQUIRE(client->findAsync(TestType::classname, {}).get().size() == 0);
+}
+
+TEST_CASE("Membership summaries", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    Serverless serverless(registry, db_path, graph);
+    Client client(registry, db_address, graph);
+    for (DbInterface *interface : std::vector<DbInterface *>{&serverless, &client})
+    {
+        interface->clear();
+        interface->add({x});
+        MembershipPtr membership = interface->getMembership();
+        REQUIRE(membership);
+        REQUIRE(membership->mayContain(x->uri()));
+        REQUIRE(!membership->mayContain("unknown"));
+        // Nothing changed, so we get the known summary back
+        REQUIRE(interface->getMembership(membership) == membership);
+        interface->remove(x->uri());
+        MembershipPtr after = interface->getMembership(membership);
+        REQUIRE(after != membership);
+        REQUIRE(after->generation != membership->generation);
+        REQUIRE(!after->mayContain(x->uri()));
+    }
+}
+
+TEST_CASE("Adding shared dependencies", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    auto y = std::make_shared<TestType>();
+    y->set_property("my_uri", "456");
+    x->add_fact("a_relation", y);
+    Serverless client(registry, db_path, graph);
+    client.clear();
+    // y is exported as dependency of x and on its own, but stored only once
+    REQUIRE(client.add({x, y, x}));
+    REQUIRE(client.find(TestType::classname, {}).size() == 2);
+    REQUIRE(client.update({y, x}, 1));
+    REQUIRE(client.find(TestType::classname, {}).size() == 2);
+    client.clear();
+}
+
+TEST_CASE("Projected find", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    Serverless serverless(registry, db_path, graph);
+    Client client(registry, db_address, graph);
+    for (DbInterface *interface : std::vector<DbInterface *>{&serverless, &client})
+    {
+        interface->clear();
+        interface->add({x});
+        const nl::json models = interface->findSpecs(TestType::classname, {}, {"classname"});
+        REQUIRE(models.size() == 1);
+        REQUIRE(models[0].size() == 2);
+        REQUIRE(models[0]["uri"] == x->uri());
+        REQUIRE(models[0]["classname"] == TestType::classname);
+        REQUIRE(interface->uris(TestType::classname, {}) == std::set<std::string>{x->uri()});
+        interface->clear();
+    }
+    // Models with many relations are projected as well (without a query, only the requested fields are kept)
+    for (int i = 0; i < 100; i++)
+    {
+        auto y = std::make_shared<TestType>();
+        y->set_property("my_uri", std::to_string(1000 + i));
+        x->add_fact("a_relation", y);
+    }
+    serverless.clear();
+    serverless.add({x}, 1);
+    const nl::json projected = serverless.findSpecs(TestType::classname, {}, {"uri"});
+    REQUIRE(projected.size() == 101);
+    for (const auto &model : projected)
+        REQUIRE(model.size() == 1);
+    REQUIRE(serverless.findSpecs(TestType::classname, {{"my_uri", "1000"}}, {"uri"}).size() == 1);
+    serverless.clear();
+}
+
+TEST_CASE("Paginated find", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    std::vector<XTypePtr> xtypes;
+    for (const std::string my_uri : {"1", "2", "3"})
+    {
+        auto x = std::make_shared<TestType>();
+        x->set_property("my_uri", my_uri);
+        xtypes.push_back(x);
+    }
+    Serverless serverless(registry, db_path, graph);
+    Client client(registry, db_address, graph);
+    for (DbInterface *interface : std::vector<DbInterface *>{&serverless, &client})
+    {
+        interface->clear();
+        interface->add(xtypes);
+        std::set<std::string> paged;
+        std::string cursor;
+        std::size_t pages = 0;
+        do
+        {
+            const nl::json page = interface->findPage(TestType::classname, {}, 2, 0, cursor, {"uri"});
+            REQUIRE(page["models"].size() <= 2);
+            for (const auto &model : page["models"])
+                paged.insert(model["uri"].get<std::string>());
+            cursor = page["cursor"].get<std::string>();
+            pages++;
+        } while (!cursor.empty());
+        REQUIRE(pages == 2);
+        REQUIRE(paged == interface->uris(TestType::classname, {}));
+        REQUIRE(interface->findPage(TestType::classname, {}, 0, 1)["models"].size() == 2);
+        REQUIRE_THROWS(interface->findPage(TestType::classname, {{"my_uri", {{"$near", 1}}}}, 2));
+        interface->clear();
+    }
+}
+
+TEST_CASE("Visiting models", "[JsonDatabaseBackend]")
+{
+    TestChain chain;
+    const auto &y = chain.y;
+    const auto &z = chain.z;
+    Serverless serverless(chain.registry, db_path, graph);
+    serverless.clear();
+    serverless.add({chain.x});
+    JsonDatabaseBackend backend(db_path, graph);
+    // Models are visited in the same order as find() returns them
+    std::vector<std::string> visited;
+    REQUIRE(backend.forEach(TestType::classname, [&](nl::json &model) {
+        visited.push_back(model["uri"].get<std::string>());
+        return true;
+    }));
+    std::vector<std::string> found;
+    for (const auto &model : backend.find(TestType::classname, {}))
+        found.push_back(model["uri"].get<std::string>());
+    REQUIRE(visited.size() == 3);
+    REQUIRE(visited == found);
+    // The scan stops as soon as the visitor returns false
+    std::size_t visits = 0;
+    REQUIRE(!backend.forEach("", [&](nl::json &) { return ++visits < 2; }));
+    REQUIRE(visits == 2);
+    // Other graphs than the working graph can be visited as well
+    JsonDatabaseBackend unbound(db_path);
+    visits = 0;
+    REQUIRE(unbound.forEach(graph, TestType::classname, [&](nl::json &) { return ++visits > 0; }));
+    REQUIRE(visits == 3);
+    // Removing the edges to z only rewrites y
+    const fs::path graph_path = fs::path(db_path) / graph;
+    std::map<fs::path, fs::file_time_type> written;
+    for (const auto &entry : fs::recursive_directory_iterator(graph_path))
+    {
+        if (fs::is_regular_file(entry.path()))
+            written[entry.path()] = fs::last_write_time(entry.path());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    backend.removeEdgesTo({z->uri()});
+    std::size_t rewritten = 0;
+    for (const auto &[path, time] : written)
+        rewritten += fs::last_write_time(path) != time;
+    REQUIRE(rewritten == 1);
+    REQUIRE(backend.findEdgesFrom({y->uri()}).empty());
+    // Edges with malformed targets are ignored
+    const nl::json edge = {{"target", 42}, {"edge_properties", nl::json::object()}};
+    const nl::json malformed = {{"uri", "malformed"}, {"classname", TestType::classname}, {"properties", nl::json::object()},
+                                {"relations", {{"a_relation", nl::json::array({edge})}}}};
+    REQUIRE(backend.add(nl::json::array({malformed})));
+    REQUIRE(backend.findEdgesFrom({"malformed"}).empty());
+    REQUIRE(backend.findEdgesTo({y->uri()}).size() == 1);
+    REQUIRE_NOTHROW(backend.removeEdgesTo({y->uri()}));
+    serverless.clear();
+}
+
+TEST_CASE("Query operators", "[Query]")
+{
+    const nl::json model = {{"uri", "a"}, {"classname", "C"}, {"properties", {{"mass", 2.5}, {"name", "arm_left"}, {"pose", {{"xyz", {1, 2, 3}}}}}}};
+    REQUIRE(Query(nl::json{{"mass", 2.5}}).matches(model));
+    REQUIRE(Query(nl::json{{"mass", {{"$gte", 1}, {"$lt", 5}}}}).matches(model));
+    REQUIRE_FALSE(Query(nl::json{{"mass", {{"$gt", 2.5}}}}).matches(model));
+    REQUIRE(Query(nl::json{{"name", {{"$prefix", "arm"}}}}).matches(model));
+    REQUIRE(Query(nl::json{{"name", {{"$regex", "LEFT$"}, {"$options", "i"}}}}).matches(model));
+    REQUIRE(Query(nl::json{{"name", {{"$in", {"arm_left", "arm_right"}}}}}).matches(model));
+    REQUIRE(Query(nl::json{{"pose.xyz.2", 3}}).matches(model));
+    REQUIRE(Query(nl::json{{"classname", "C"}, {"color", {{"$exists", false}}}}).matches(model));
+    REQUIRE(Query(nl::json{{"$or", {{{"mass", 1}}, {{"name", {{"$ne", "leg"}}}}}}}).matches(model));
+    REQUIRE_FALSE(Query(nl::json{{"$not", {{"mass", 2.5}}}}).matches(model));
+    REQUIRE(Query(nl::json{{"uri", {{"$in", {"a", "b"}}}}}).uris() == std::set<std::string>{"a", "b"});
+    REQUIRE_THROWS_AS(Query(nl::json{{"mass", {{"$near", 1}}}}), std::invalid_argument);
+    // An empty query needs no keys at all, an $edge condition without relation needs the complete model
+    REQUIRE(Query().keys().empty());
+    REQUIRE(!Query().complete());
+    REQUIRE(Query(nl::json{{"pose.xyz", 1}}).keys() == std::set<std::string>{"pose", "pose.xyz"});
+    REQUIRE(Query(nl::json{{"$edge", {{"target", "b"}}}}).complete());
+
+    auto registry = std::make_shared<ProjectRegistry>();
+    std::vector<XTypePtr> xtypes;
+    for (const std::string my_uri : {"a1", "a2", "b1"})
+    {
+        auto x = std::make_shared<TestType>();
+        x->set_property("my_uri", my_uri);
+        xtypes.push_back(x);
+    }
+    Serverless serverless(registry, db_path, graph);
+    Client client(registry, db_address, graph);
+    for (DbInterface *interface : std::vector<DbInterface *>{&serverless, &client})
+    {
+        interface->clear();
+        interface->add(xtypes);
+        REQUIRE(interface->findSpecs(TestType::classname, {{"my_uri", {{"$prefix", "a"}}}}).size() == 2);
+        REQUIRE(interface->findSpecs(TestType::classname, {{"$or", {{{"my_uri", "a1"}}, {{"my_uri", "b1"}}}}}).size() == 2);
+        REQUIRE(interface->findSpecs(TestType::classname, {{"uri", {{"$in", {xtypes[0]->uri(), xtypes[2]->uri()}}}}}).size() == 2);
+        interface->clear();
+    }
+}
+
+TEST_CASE("Relation queries", "[DbInterface]")
+{
+    const nl::json relations = {{"has_part", {{{"target", "b"}, {"edge_properties", {{"weight", 2}}}}}}};
+    const nl::json model = {{"uri", "a"}, {"classname", "C"}, {"properties", nl::json::object()}, {"relations", relations}};
+    REQUIRE(Query(nl::json{{"$edge", {{"relation", "has_part"}, {"target", "b"}}}}).matches(model));
+    REQUIRE(Query(nl::json{{"$edge", {{"edge_properties", {{"weight", {{"$gt", 1}}}}}}}}).matchesRelations(relations));
+    REQUIRE_FALSE(Query(nl::json{{"$edge", {{"relation", "has_part"}, {"target", "c"}}}}).matches(model));
+
+    withTestChain([](DbInterface &interface, TestChain &chain) {
+        // NOTE: Inverse edges might be stored as well, so we only check for the forward ones
+        REQUIRE(interface.uris(TestType::classname, {{"$edge", {{"relation", "a_relation"}, {"target", chain.y->uri()}}}}).count(chain.x->uri()) == 1);
+        REQUIRE(interface.uris(TestType::classname, {{"$edge", {{"relation", "a_relation"}, {"target", chain.z->uri()}}}}).count(chain.x->uri()) == 0);
+        REQUIRE(interface.uris(TestType::classname, {{"$edge", {{"relation", "unknown_relation"}}}}).empty());
+    });
+}
+
+TEST_CASE("Edge queries", "[DbInterface]")
+{
+    withTestChain([](DbInterface &interface, TestChain &chain) {
+        const std::string x = chain.x->uri();
+        const nl::json from = interface.findEdgesFrom({x});
+        REQUIRE(from.size() == 1);
+        REQUIRE(from[x]["a_relation"][0]["target"] == chain.y->uri());
+        const nl::json to = interface.findEdgesTo({chain.y->uri()});
+        REQUIRE(to.contains(x));
+        REQUIRE(to[x]["a_relation"][0]["source"] == x);
+        REQUIRE(interface.findEdgesTo({"unknown_uri"}).empty());
+    });
+}
+
+TEST_CASE("Graph traversal", "[DbInterface]")
+{
+    withTestChain([](DbInterface &interface, TestChain &chain) {
+        const std::string x = chain.x->uri();
+        const nl::json closure = interface.traverse(x, {"a_relation"}, "out", -1, false, true);
+        REQUIRE(closure.size() == 3);
+        REQUIRE(closure[0] == x);
+        REQUIRE(interface.traverse(x, {"a_relation"}, "out", 1, true, true).size() == 2);
+        REQUIRE(interface.traverse(x, {"unknown_relation"}).size() == 1);
+        // z depends on y which depends on x
+        const nl::json dependants = interface.traverse(chain.z->uri(), {"a_relation"}, "in");
+        REQUIRE(dependants.size() == 3);
+        REQUIRE(dependants[2]["uri"] == x);
+        // Errors of the server are not hidden by a fallback
+        REQUIRE_THROWS(interface.traverse(x, {}, "sideways"));
+    });
+}
+
+TEST_CASE("Depth-limited traversal", "[DbInterface]")
+{
+    // Diamond: D is reached via B (depth 2) before it is reached directly (depth 1)
+    const std::map<std::string, std::vector<std::string>> graph = {{"A", {"B", "D"}}, {"B", {"D"}}, {"D", {"E"}}};
+    const auto neighbours = [&graph](const std::string &uri) {
+        auto it = graph.find(uri);
+        return it != graph.end() ? it->second : std::vector<std::string>();
+    };
+    REQUIRE(models::traverseUris("A", 2, true, neighbours) == std::vector<std::string>{"A", "B", "D", "E"});
+    REQUIRE(models::traverseUris("A", 2, false, neighbours) == std::vector<std::string>{"A", "B", "D", "E"});
+    REQUIRE(models::traverseUris("A", 1, true, neighbours) == std::vector<std::string>{"A", "B", "D"});
+    REQUIRE(models::traverseUris("A", -1, true, neighbours) == std::vector<std::string>{"A", "B", "D", "E"});
+}
+
+TEST_CASE("Sorted find", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    std::vector<XTypePtr> xtypes;
+    for (const std::string my_uri : {"2", "3", "1"})
+    {
+        auto x = std::make_shared<TestType>();
+        x->set_property("my_uri", my_uri);
+        xtypes.push_back(x);
+    }
+    Serverless serverless(registry, db_path, graph);
+    Client client(registry, db_address, graph);
+    for (DbInterface *interface : std::vector<DbInterface *>{&serverless, &client})
+    {
+        interface->clear();
+        interface->add(xtypes);
+        const nl::json top = interface->findSorted(TestType::classname, {}, {"-my_uri"}, 2, {"uri"});
+        REQUIRE(top.size() == 2);
+        REQUIRE(top[0]["uri"] == xtypes[1]->uri());
+        REQUIRE(top[1]["uri"] == xtypes[0]->uri());
+        const nl::json all = interface->findSorted(TestType::classname, {}, {"my_uri"});
+        REQUIRE(all.size() == 3);
+        REQUIRE(all[0]["uri"] == xtypes[2]->uri());
+        interface->clear();
+    }
+}
+
+TEST_CASE("Counting models", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    std::vector<XTypePtr> xtypes;
+    for (const std::string my_uri : {"a", "a", "b"})
+    {
+        auto x = std::make_shared<TestType>();
+        x->set_property("my_uri", my_uri);
+        xtypes.push_back(x);
+    }
+    Serverless serverless(registry, db_path, graph);
+    Client client(registry, db_address, graph);
+    for (DbInterface *interface : std::vector<DbInterface *>{&serverless, &client})
+    {
+        interface->clear();
+        interface->add(xtypes);
+        // Both "a" share the same uri, so they are stored as one model
+        REQUIRE(interface->count(TestType::classname) == 2);
+        REQUIRE(interface->count() == 2);
+        REQUIRE(interface->count(TestType::classname, {{"my_uri", "b"}}) == 1);
+        REQUIRE(interface->groupCount(TestType::classname, "my_uri") == nl::json{{"a", 1}, {"b", 1}});
+        REQUIRE(interface->count(TestType::classname, {{"my_uri", "unknown"}}) == 0);
+        // Errors of the server are not hidden by a fallback
+        REQUIRE_THROWS(interface->count(TestType::classname, {{"my_uri", {{"$near", 1}}}}));
+        interface->clear();
+    }
+}
+
+TEST_CASE("Patching models", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    Serverless serverless(registry, db_path, graph);
+    Client client(registry, db_address, graph);
+    for (DbInterface *interface : std::vector<DbInterface *>{&serverless, &client})
+    {
+        interface->clear();
+        interface->add({x});
+        const std::string path = "/properties/a_property";
+        // RFC 6902
+        REQUIRE(interface->patch(x->uri(), {{{"op", "replace"}, {"path", path}, {"value", "patched"}}}));
+        REQUIRE(interface->loadSpec(x->uri())[nl::json::json_pointer(path)] == "patched");
+        // RFC 7386
+        REQUIRE(interface->patch(x->uri(), {{"properties", {{"a_property", "merged"}}}}));
+        REQUIRE(interface->loadSpec(x->uri())[nl::json::json_pointer(path)] == "merged");
+        REQUIRE_THROWS(interface->patch(x->uri(), {{"uri", "something else"}}));
+        REQUIRE(!interface->patch("unknown", {{"a_property", "merged"}}));
+        // Models stored in the old flat format are rejected and left untouched
+        const nl::json flat = {{"uri", "flat_model"}, {"classname", TestType::classname}, {"a_property", "flat"}};
+        REQUIRE(interface->add(nl::json::array({flat})));
+        REQUIRE_THROWS(interface->patch("flat_model", {{"a_property", "patched"}}));
+        REQUIRE(interface->loadSpec("flat_model")["a_property"] == "flat");
+        interface->clear();
+    }
+}
+
+TEST_CASE("Dirty tracking", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    Serverless client(registry, db_path, graph);
+    Serverless other(registry, db_path, graph);
+    client.setDirtyTracking(true);
+    // Models might store their properties flat or in a "properties" object
+    auto stored_property = [&]() {
+        const nl::json model = client.loadSpec(x->uri());
+        return model.contains("properties") ? model["properties"]["a_property"] : model["a_property"];
+    };
+    client.clear();
+    client.add({x});
+    // x is in sync once it has been loaded
+    client.load(x->uri());
+    // Someone else changes x ...
+    nl::json changed = client.loadSpec(x->uri());
+    (changed.contains("properties") ? changed["properties"] : changed)["a_property"] = "changed by other";
+    other.update(nl::json::array({changed}));
+    // ... so updating the unchanged x does not write anything
+    REQUIRE(client.update({x}));
+    REQUIRE(stored_property() == "changed by other");
+    // but a changed x is written
+    x->set_property("a_property", "changed by us");
+    REQUIRE(client.update({x}));
+    REQUIRE(stored_property() == "changed by us");
+    // Written models are not assumed to be in sync, so x is written again
+    other.update(nl::json::array({changed}));
+    REQUIRE(client.update({x}));
+    REQUIRE(stored_property() == "changed by us");
+    // The same holds for patched ones
+    const std::string path = client.loadSpec(x->uri()).contains("properties") ? "/properties/a_property" : "/a_property";
+    REQUIRE(client.patch(x->uri(), {{{"op", "replace"}, {"path", path}, {"value", "patched"}}}));
+    REQUIRE(client.update({x}));
+    REQUIRE(stored_property() == "changed by us");
+    client.setDirtyTracking(false);
+    other.update(nl::json::array({changed}));
+    REQUIRE(client.update({x}));
+    REQUIRE(stored_property() == "changed by us");
+    client.clear();
+}
+
+TEST_CASE("Subgraph loading", "[DbInterface]")
+{
+    withTestChain([](DbInterface &interface, TestChain &chain) {
+        const std::string x = chain.x->uri();
+        REQUIRE(interface.loadSubgraphSpecs(x).size() == 3);
+        REQUIRE(interface.loadSubgraphSpecs(x, -1, {"unknown_relation"}).size() == 1);
+        chain.registry->clear();
+        // Depth 1 covers x and its direct neighbour y
+        REQUIRE(interface.loadSubgraph(x, 1)->uri() == x);
+        REQUIRE(chain.registry->knows_uri(x));
+        REQUIRE(chain.registry->knows_uri(chain.y->uri()));
+        REQUIRE(!chain.registry->knows_uri(chain.z->uri()));
+        chain.registry->clear();
+        interface.loadSubgraph(x);
+        REQUIRE(chain.registry->knows_uri(chain.z->uri()));
+    });
+}
+
+TEST_CASE("Identity map", "[DbInterface]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    Serverless client(registry, db_path, graph);
+    client.setIdentityMap(true);
+    client.clear();
+    client.add({x});
+    registry->clear();
+    XTypePtr first = client.load(x->uri());
+    REQUIRE(first.get() != x.get());
+    // Unchanged models are not deserialized again
+    REQUIRE(client.load(x->uri()).get() == first.get());
+    x->set_property("a_property", "changed");
+    client.update({x});
+    XTypePtr updated = client.load(x->uri());
+    REQUIRE(updated->get_property("a_property") == "changed");
+    client.clear();
+}
+
+TEST_CASE("MultiDbClient routing", "[MultiDbClient]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    nl::json config = readJson(std::getenv("TEST_MULTIDB_CONFIG"));
+    config["routing"] = {{{"classname", "unknown::.*"}, {"import_servers", {"not_configured"}}}};
+    REQUIRE_THROWS(MultiDbClient(registry, config));
+    config["routing"] = {{{"classname", TestType::classname}, {"import_servers", {"main_server (read)"}}}};
+    MultiDbClient client(registry, config);
+    client.clear();
+    client.add({x});
+    registry->clear();
+    REQUIRE(client.find(TestType::classname, {}).size() == 1);
+    REQUIRE(client.uris(TestType::classname, {}).count(x->uri()) == 1);
+    REQUIRE(client.load(x->uri(), TestType::classname)->uri() == x->uri());
+    bool partial = true;
+    REQUIRE(client.uris(TestType::classname, {}, partial).count(x->uri()) == 1);
+    REQUIRE(!partial);
+    // Only the routed import server has been asked ...
+    nl::json statistics = client.getStatistics();
+    REQUIRE(statistics.size() == 3);
+    REQUIRE(statistics["main_server (read)"]["calls"].get<std::size_t>() > 0);
+    REQUIRE(statistics["main_server (read)"]["hits"].get<std::size_t>() > 0);
+    REQUIRE(statistics["my_client"]["calls"].get<std::size_t>() == 0);
+    REQUIRE(statistics["my_serverless"]["calls"].get<std::size_t>() == 0);
+    // ... but all of them are asked without a classname
+    client.resetStatistics();
+    client.uris("", {});
+    statistics = client.getStatistics();
+    REQUIRE(statistics["my_client"]["calls"].get<std::size_t>() == 1);
+    REQUIRE(statistics["my_serverless"]["calls"].get<std::size_t>() == 1);
+    client.clear();
+
+    // Unnamed import servers are named by their position
+    config["import_servers"][2].erase("name");
+    MultiDbClient unnamed(registry, config);
+    REQUIRE(unnamed.uris(TestType::classname, {}).empty());
+    statistics = unnamed.getStatistics();
+    REQUIRE(statistics.contains("2"));
+    REQUIRE(statistics["2"]["calls"].get<std::size_t>() == 0);
+}
+
+TEST_CASE("Negative cache", "[Client]")
+{
+    auto registry = std::make_shared<ProjectRegistry>();
+    auto x = registry->instantiate<TestType>();
+    Client client(registry, db_address, graph);
+    client.setNegativeCache(10, 60000);
+    client.clear();
+    REQUIRE(client.loadSpec(x->uri()).empty());
+    // Writing through the client has to forget the previous miss
+    client.add({x});
+    REQUIRE(client.loadSpec(x->uri())["uri"] == x->uri());
+    client.remove(x->uri());
+    REQUIRE(client.loadSpec(x->uri()).empty());
+}
+
 TEST_CASE("Ping server", "ping pong")
 {
     using namespace std::literals;
@@ -284,6 +829,55 @@ TEST_CASE("Ping server", "ping pong")
     }
 }
 
+TEST_CASE("Client connection pool", "[Client]")
+{
+    auto registry = std::make_shared<XTypeRegistry>();
+    Client client = Client(registry, db_address, graph);
+    client.setConnectionPoolSize(2);
+    REQUIRE(client.getConnectionPoolSize() == 2);
+    // More threads than sessions: requests have to wait for and reuse the pooled sessions
+    std::vector<std::future<std::time_t>> pings;
+    for (int i = 0; i < 8; i++)
+        pings.push_back(std::async(std::launch::async, [&client] { return client.ping(); }));
+    for (auto &ping : pings)
+        REQUIRE(ping.get() != -1);
+    REQUIRE_THROWS(client.setConnectionPoolSize(0));
+}
+
+TEST_CASE("Client readiness", "[Client]")
+{
+    // Exposes the time of the last contact to the server
+    struct ObservedClient : Client
+    {
+        using Client::Client;
+        using Client::lastContact;
+    };
+    auto registry = std::make_shared<XTypeRegistry>();
+    ObservedClient client(registry, db_address, graph);
+    client.setReadinessTTL(60000);
+    REQUIRE(client.isReady());
+    // Within the TTL, the readiness is known without contacting the server ...
+    const auto contact = client.lastContact.load();
+    REQUIRE(client.isReady());
+    REQUIRE(client.lastContact.load() == contact);
+    // ... and every answered request counts as contact
+    client.loadSpec("unknown");
+    REQUIRE(client.lastContact.load() > contact);
+    REQUIRE_THROWS(client.startHealthCheck(0));
+
+    // A server which did not answer is not asked again within the retry interval ...
+    ObservedClient offline(registry, "http://localhost:1", graph);
+    offline.setRetryInterval(60000);
+    REQUIRE(!offline.isReady());
+    const auto failed = offline.lastContact.load();
+    REQUIRE_THROWS(offline.loadSpec("unknown"));
+    REQUIRE(offline.lastContact.load() == failed);
+    // ... but right after it (independent of the readiness TTL)
+    offline.setRetryInterval(0);
+    REQUIRE_THROWS(offline.loadSpec("unknown"));
+    REQUIRE(offline.lastContact.load() > failed);
+}
+
 TEST_CASE("Test XTypeRegistry", "XTypeRegistry")
 {
     auto registry = std::make_shared<XTypeRegistry>();